@@ -8,40 +8,96 @@
  * 			\n runs the BAM with a clean picture
  * 		   	\n waiting for new picture data
  *
- * \todo	temperature control -> ADC + handle
- *     		\n watchdog
- *     		\n hardware revision 2 adjustment
+ * \todo	hardware revision 2 adjustment
  *      	\n-PWM Blank, fan GPIO, Blank polarity
  */
 
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include <avr/sleep.h>
 #include "bam.h"
 #include "transceive_data.h"
+#include "ingest.h"
+#include "power.h"
+#include "crc.h"
+#include "command.h"
+#include "telemetry.h"
+#include "profiler.h"
+#include "thermal.h"
+#include "watchdog.h"
+#include "clip.h"
+#include "effect.h"
+
+// POWER REDUCTION - modules without use, timer 0 and timer 2 are the profiler timebase
+#ifdef PROFILER_ENABLE
+#define MAIN_PRR_MASK ((1<<PRTWI)|(1<<PRUSART0))
+#else
+#define MAIN_PRR_MASK ((1<<PRTWI)|(1<<PRTIM2)|(1<<PRUSART0)|(1<<PRTIM0))
+#endif
 
 /** \brief 	main
  *
  * \details    Initialize the system
  *  			\n run BAM
  *  			\n waiting for new picture data
+ *  			\n between the events the cpu sleeps (idle), every isr wakes it,
+ *  			\n the BAM isr at least every 2.6mS
+ *  			\n wake latency (cycle count, not measured): idle keeps the clock running, the
+ *  			\n wake up halts the cpu 4 cycles on top of the 4 cycles interrupt response,
+ *  			\n LATCH -> check_valid_rx_data() = 8 + LATCH isr + ~12 (reti, sleep_disable,
+ *  			\n sei, call) cycles, ~1µS + LATCH isr at 20MHz. A running BAM isr delays it
+ *  			\n as before, the busy loop needed up to one whole pass (~10µS) instead.
+ *  			\n idle current (datasheet curves ATmega88PA 5V 20MHz, not measured): active
+ *  			\n ~9mA, idle ~2.5mA, with the BAM isr duty some 3-4mA for the cpu, small
+ *  			\n against the LED current
+ *  			\n temperature control -> check_thermal()
+ *  			\n watchdog, after a watchdog reset the shown frame is kept -> init_BAM()
  *
- * \todo      	temperature control -> ADC + handle
- *     			\n watchdog
- *     			\n hardware revision 2 adjustment
+ * \todo      	hardware revision 2 adjustment
  *      		\n-PWM Blank, fan GPIO, Blank polarity
  */
 int main(void)
 {
-	// wdt reset!!!
+	uint16_t sum[BAM_CHANNELS];
+	PRR = MAIN_PRR_MASK;
+	set_sleep_mode(SLEEP_MODE_IDLE);
 	init_SPI();
 	init_PIN_CHANGE_ISR();
-	init_BAM();
+	init_BAM(get_reset_flags() & WATCHDOG_RESET_MASK);
+	init_ingest();
+	init_power();
+	init_crc();
+	init_cmd();
+	init_telemetry();
+	init_thermal();
+#ifdef PROFILER_ENABLE
+	init_profiler();
+#endif
 	sei();
+	// current limit of the kept or splash frame
+	sum_bam_mem(sum);
+	set_frame_power(sum);
+	init_watchdog();
 	start_timer();
     while(1)
     {
 		check_valid_rx_data();
-		// temperature control ()!!!!
-		// watchdog!!!!
+		check_thermal();
+		check_bam_splash();
+		check_clip();
+		check_effect();
+#ifdef BAM_SINGLE_BUFFER
+		check_bam_stage();
+#endif
+		wdt_reset();
+		// sleep until the next isr, a LATCH which came in meanwhile is handled first
+		cli();
+		if(!get_rx_pending()){
+			sleep_enable();
+			sei(); // the instruction after sei is executed first, no isr is lost before sleep
+			sleep_cpu();
+			sleep_disable();
+		}
+		sei();
 	}
 }
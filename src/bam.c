@@ -14,7 +14,10 @@
 
 #include "bam.h"
 #include "transceive_data.h"
+#include "profiler.h"
 #include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <avr/eeprom.h>
 #include <util/delay.h>
 #include <avr/interrupt.h>
 
@@ -40,162 +43,106 @@ static volatile const uint8_t bam_timer_map_h[BAM_STEPS]={
 	BAM_TMR_RLD_STP_6_H,
 	BAM_TMR_RLD_STP_7_H }; //!< Lookuptable - timer16 high byte reload, map used in ISR(TIMER_16_vect)
 
-// BAM STEP TABLE POSITION MAP - for transmit 
+// BAM BLANK MAP - compare value per step, written by set_bam_duty()
+static volatile uint8_t bam_blank_map_l[BAM_STEPS]; //!< timer16 low byte compare map, used in ISR(TIMER_16_vect)
+static volatile uint8_t bam_blank_map_h[BAM_STEPS]; //!< timer16 high byte compare map, used in ISR(TIMER_16_vect)
+static volatile uint8_t bam_duty; //!< current duty, BAM_DUTY_MAX/BAM_DUTY_OFF = compare isr disabled, used in ISR(TIMER_16_vect)
+
+// BAM STEP TABLE POSITION MAP - for transmit, 16 bit above 256 Byte tables
+#if BAM_MEM_SIZE > 256
+static const uint16_t bam_step_map[BAM_STEPS]={
+#else
 static const uint8_t bam_step_map[BAM_STEPS]={
+#endif
 	BAM_TBL_POS_STEP_0,BAM_TBL_POS_STEP_1,BAM_TBL_POS_STEP_2,BAM_TBL_POS_STEP_3,
 	BAM_TBL_POS_STEP_4,BAM_TBL_POS_STEP_5,BAM_TBL_POS_STEP_6,BAM_TBL_POS_STEP_7
  };	//!< Lookuptable - timer16 reload map offset, used in ISR(TIMER_16_vect)
 
-// Maps for look up
-// BIT MASK = STRING 0 - 5 TLC SPI
-static const uint8_t lookup_bit_mask[] = {
-	 LED_0_0_R_BIT_POS_MASK,LED_0_0_G_BIT_POS_MASK,LED_0_0_B_BIT_POS_MASK,
-	 LED_1_0_R_BIT_POS_MASK,LED_1_0_G_BIT_POS_MASK,LED_1_0_B_BIT_POS_MASK,
-	 LED_2_0_R_BIT_POS_MASK,LED_2_0_G_BIT_POS_MASK,LED_2_0_B_BIT_POS_MASK,
-	 LED_3_0_R_BIT_POS_MASK,LED_3_0_G_BIT_POS_MASK,LED_3_0_B_BIT_POS_MASK,
-	 LED_4_0_R_BIT_POS_MASK,LED_4_0_G_BIT_POS_MASK,LED_4_0_B_BIT_POS_MASK,
-	 LED_5_0_R_BIT_POS_MASK,LED_5_0_G_BIT_POS_MASK,LED_5_0_B_BIT_POS_MASK,
-	 LED_6_0_R_BIT_POS_MASK,LED_6_0_G_BIT_POS_MASK,LED_6_0_B_BIT_POS_MASK,
-	 LED_7_0_R_BIT_POS_MASK,LED_7_0_G_BIT_POS_MASK,LED_7_0_B_BIT_POS_MASK,
-	 LED_0_1_R_BIT_POS_MASK,LED_0_1_G_BIT_POS_MASK,LED_0_1_B_BIT_POS_MASK,
-	 LED_1_1_R_BIT_POS_MASK,LED_1_1_G_BIT_POS_MASK,LED_1_1_B_BIT_POS_MASK,
-	 LED_2_1_R_BIT_POS_MASK,LED_2_1_G_BIT_POS_MASK,LED_2_1_B_BIT_POS_MASK,
-	 LED_3_1_R_BIT_POS_MASK,LED_3_1_G_BIT_POS_MASK,LED_3_1_B_BIT_POS_MASK,
-	 LED_4_1_R_BIT_POS_MASK,LED_4_1_G_BIT_POS_MASK,LED_4_1_B_BIT_POS_MASK,
-	 LED_5_1_R_BIT_POS_MASK,LED_5_1_G_BIT_POS_MASK,LED_5_1_B_BIT_POS_MASK,
-	 LED_6_1_R_BIT_POS_MASK,LED_6_1_G_BIT_POS_MASK,LED_6_1_B_BIT_POS_MASK,
-	 LED_7_1_R_BIT_POS_MASK,LED_7_1_G_BIT_POS_MASK,LED_7_1_B_BIT_POS_MASK,
-	 LED_0_2_R_BIT_POS_MASK,LED_0_2_G_BIT_POS_MASK,LED_0_2_B_BIT_POS_MASK,
-	 LED_1_2_R_BIT_POS_MASK,LED_1_2_G_BIT_POS_MASK,LED_1_2_B_BIT_POS_MASK,
-	 LED_2_2_R_BIT_POS_MASK,LED_2_2_G_BIT_POS_MASK,LED_2_2_B_BIT_POS_MASK,
-	 LED_3_2_R_BIT_POS_MASK,LED_3_2_G_BIT_POS_MASK,LED_3_2_B_BIT_POS_MASK,
-	 LED_4_2_R_BIT_POS_MASK,LED_4_2_G_BIT_POS_MASK,LED_4_2_B_BIT_POS_MASK,
-	 LED_5_2_R_BIT_POS_MASK,LED_5_2_G_BIT_POS_MASK,LED_5_2_B_BIT_POS_MASK,
-	 LED_6_2_R_BIT_POS_MASK,LED_6_2_G_BIT_POS_MASK,LED_6_2_B_BIT_POS_MASK,
-	 LED_7_2_R_BIT_POS_MASK,LED_7_2_G_BIT_POS_MASK,LED_7_2_B_BIT_POS_MASK,
-	 LED_0_3_R_BIT_POS_MASK,LED_0_3_G_BIT_POS_MASK,LED_0_3_B_BIT_POS_MASK,
-	 LED_1_3_R_BIT_POS_MASK,LED_1_3_G_BIT_POS_MASK,LED_1_3_B_BIT_POS_MASK,
-	 LED_2_3_R_BIT_POS_MASK,LED_2_3_G_BIT_POS_MASK,LED_2_3_B_BIT_POS_MASK,
-	 LED_3_3_R_BIT_POS_MASK,LED_3_3_G_BIT_POS_MASK,LED_3_3_B_BIT_POS_MASK,
-	 LED_4_3_R_BIT_POS_MASK,LED_4_3_G_BIT_POS_MASK,LED_4_3_B_BIT_POS_MASK,
-	 LED_5_3_R_BIT_POS_MASK,LED_5_3_G_BIT_POS_MASK,LED_5_3_B_BIT_POS_MASK,
-	 LED_6_3_R_BIT_POS_MASK,LED_6_3_G_BIT_POS_MASK,LED_6_3_B_BIT_POS_MASK,
-	 LED_7_3_R_BIT_POS_MASK,LED_7_3_G_BIT_POS_MASK,LED_7_3_B_BIT_POS_MASK,
-	 LED_0_4_R_BIT_POS_MASK,LED_0_4_G_BIT_POS_MASK,LED_0_4_B_BIT_POS_MASK,
-	 LED_1_4_R_BIT_POS_MASK,LED_1_4_G_BIT_POS_MASK,LED_1_4_B_BIT_POS_MASK,
-	 LED_2_4_R_BIT_POS_MASK,LED_2_4_G_BIT_POS_MASK,LED_2_4_B_BIT_POS_MASK,
-	 LED_3_4_R_BIT_POS_MASK,LED_3_4_G_BIT_POS_MASK,LED_3_4_B_BIT_POS_MASK,
-	 LED_4_4_R_BIT_POS_MASK,LED_4_4_G_BIT_POS_MASK,LED_4_4_B_BIT_POS_MASK,
-	 LED_5_4_R_BIT_POS_MASK,LED_5_4_G_BIT_POS_MASK,LED_5_4_B_BIT_POS_MASK,
-	 LED_6_4_R_BIT_POS_MASK,LED_6_4_G_BIT_POS_MASK,LED_6_4_B_BIT_POS_MASK,
-	 LED_7_4_R_BIT_POS_MASK,LED_7_4_G_BIT_POS_MASK,LED_7_4_B_BIT_POS_MASK,
-	 LED_0_5_R_BIT_POS_MASK,LED_0_5_G_BIT_POS_MASK,LED_0_5_B_BIT_POS_MASK,
-	 LED_1_5_R_BIT_POS_MASK,LED_1_5_G_BIT_POS_MASK,LED_1_5_B_BIT_POS_MASK,
-	 LED_2_5_R_BIT_POS_MASK,LED_2_5_G_BIT_POS_MASK,LED_2_5_B_BIT_POS_MASK,
-	 LED_3_5_R_BIT_POS_MASK,LED_3_5_G_BIT_POS_MASK,LED_3_5_B_BIT_POS_MASK,
-	 LED_4_5_R_BIT_POS_MASK,LED_4_5_G_BIT_POS_MASK,LED_4_5_B_BIT_POS_MASK,
-	 LED_5_5_R_BIT_POS_MASK,LED_5_5_G_BIT_POS_MASK,LED_5_5_B_BIT_POS_MASK,
-	 LED_6_5_R_BIT_POS_MASK,LED_6_5_G_BIT_POS_MASK,LED_6_5_B_BIT_POS_MASK,
-	 LED_7_5_R_BIT_POS_MASK,LED_7_5_G_BIT_POS_MASK,LED_7_5_B_BIT_POS_MASK,
-	 LED_0_6_R_BIT_POS_MASK,LED_0_6_G_BIT_POS_MASK,LED_0_6_B_BIT_POS_MASK,
-	 LED_1_6_R_BIT_POS_MASK,LED_1_6_G_BIT_POS_MASK,LED_1_6_B_BIT_POS_MASK,
-	 LED_2_6_R_BIT_POS_MASK,LED_2_6_G_BIT_POS_MASK,LED_2_6_B_BIT_POS_MASK,
-	 LED_3_6_R_BIT_POS_MASK,LED_3_6_G_BIT_POS_MASK,LED_3_6_B_BIT_POS_MASK,
-	 LED_4_6_R_BIT_POS_MASK,LED_4_6_G_BIT_POS_MASK,LED_4_6_B_BIT_POS_MASK,
-	 LED_5_6_R_BIT_POS_MASK,LED_5_6_G_BIT_POS_MASK,LED_5_6_B_BIT_POS_MASK,
-	 LED_6_6_R_BIT_POS_MASK,LED_6_6_G_BIT_POS_MASK,LED_6_6_B_BIT_POS_MASK,
-	 LED_7_6_R_BIT_POS_MASK,LED_7_6_G_BIT_POS_MASK,LED_7_6_B_BIT_POS_MASK,
-	 LED_0_7_R_BIT_POS_MASK,LED_0_7_G_BIT_POS_MASK,LED_0_7_B_BIT_POS_MASK,
-	 LED_1_7_R_BIT_POS_MASK,LED_1_7_G_BIT_POS_MASK,LED_1_7_B_BIT_POS_MASK,
-	 LED_2_7_R_BIT_POS_MASK,LED_2_7_G_BIT_POS_MASK,LED_2_7_B_BIT_POS_MASK,
-	 LED_3_7_R_BIT_POS_MASK,LED_3_7_G_BIT_POS_MASK,LED_3_7_B_BIT_POS_MASK,
-	 LED_4_7_R_BIT_POS_MASK,LED_4_7_G_BIT_POS_MASK,LED_4_7_B_BIT_POS_MASK,
-	 LED_5_7_R_BIT_POS_MASK,LED_5_7_G_BIT_POS_MASK,LED_5_7_B_BIT_POS_MASK,
-	 LED_6_7_R_BIT_POS_MASK,LED_6_7_G_BIT_POS_MASK,LED_6_7_B_BIT_POS_MASK,
-	 LED_7_7_R_BIT_POS_MASK,LED_7_7_G_BIT_POS_MASK,LED_7_7_B_BIT_POS_MASK }; //!< Lookuptable - Bit position used in process_bam_input()
-
-// BYTE Pos = TLCOUT BIT NO.
-static const uint8_t lookup_byte_pos[] = {
-	 LED_0_0_R_BYTE_POS,LED_0_0_G_BYTE_POS,LED_0_0_B_BYTE_POS,
-	 LED_1_0_R_BYTE_POS,LED_1_0_G_BYTE_POS,LED_1_0_B_BYTE_POS,
-	 LED_2_0_R_BYTE_POS,LED_2_0_G_BYTE_POS,LED_2_0_B_BYTE_POS,
-	 LED_3_0_R_BYTE_POS,LED_3_0_G_BYTE_POS,LED_3_0_B_BYTE_POS,
-	 LED_4_0_R_BYTE_POS,LED_4_0_G_BYTE_POS,LED_4_0_B_BYTE_POS,
-	 LED_5_0_R_BYTE_POS,LED_5_0_G_BYTE_POS,LED_5_0_B_BYTE_POS,
-	 LED_6_0_R_BYTE_POS,LED_6_0_G_BYTE_POS,LED_6_0_B_BYTE_POS,
-	 LED_7_0_R_BYTE_POS,LED_7_0_G_BYTE_POS,LED_7_0_B_BYTE_POS,
-	 LED_0_1_R_BYTE_POS,LED_0_1_G_BYTE_POS,LED_0_1_B_BYTE_POS,
-	 LED_1_1_R_BYTE_POS,LED_1_1_G_BYTE_POS,LED_1_1_B_BYTE_POS,
-	 LED_2_1_R_BYTE_POS,LED_2_1_G_BYTE_POS,LED_2_1_B_BYTE_POS,
-	 LED_3_1_R_BYTE_POS,LED_3_1_G_BYTE_POS,LED_3_1_B_BYTE_POS,
-	 LED_4_1_R_BYTE_POS,LED_4_1_G_BYTE_POS,LED_4_1_B_BYTE_POS,
-	 LED_5_1_R_BYTE_POS,LED_5_1_G_BYTE_POS,LED_5_1_B_BYTE_POS,
-	 LED_6_1_R_BYTE_POS,LED_6_1_G_BYTE_POS,LED_6_1_B_BYTE_POS,
-	 LED_7_1_R_BYTE_POS,LED_7_1_G_BYTE_POS,LED_7_1_B_BYTE_POS,
-	 LED_0_2_R_BYTE_POS,LED_0_2_G_BYTE_POS,LED_0_2_B_BYTE_POS,
-	 LED_1_2_R_BYTE_POS,LED_1_2_G_BYTE_POS,LED_1_2_B_BYTE_POS,
-	 LED_2_2_R_BYTE_POS,LED_2_2_G_BYTE_POS,LED_2_2_B_BYTE_POS,
-	 LED_3_2_R_BYTE_POS,LED_3_2_G_BYTE_POS,LED_3_2_B_BYTE_POS,
-	 LED_4_2_R_BYTE_POS,LED_4_2_G_BYTE_POS,LED_4_2_B_BYTE_POS,
-	 LED_5_2_R_BYTE_POS,LED_5_2_G_BYTE_POS,LED_5_2_B_BYTE_POS,
-	 LED_6_2_R_BYTE_POS,LED_6_2_G_BYTE_POS,LED_6_2_B_BYTE_POS,
-	 LED_7_2_R_BYTE_POS,LED_7_2_G_BYTE_POS,LED_7_2_B_BYTE_POS,
-	 LED_0_3_R_BYTE_POS,LED_0_3_G_BYTE_POS,LED_0_3_B_BYTE_POS,
-	 LED_1_3_R_BYTE_POS,LED_1_3_G_BYTE_POS,LED_1_3_B_BYTE_POS,
-	 LED_2_3_R_BYTE_POS,LED_2_3_G_BYTE_POS,LED_2_3_B_BYTE_POS,
-	 LED_3_3_R_BYTE_POS,LED_3_3_G_BYTE_POS,LED_3_3_B_BYTE_POS,
-	 LED_4_3_R_BYTE_POS,LED_4_3_G_BYTE_POS,LED_4_3_B_BYTE_POS,
-	 LED_5_3_R_BYTE_POS,LED_5_3_G_BYTE_POS,LED_5_3_B_BYTE_POS,
-	 LED_6_3_R_BYTE_POS,LED_6_3_G_BYTE_POS,LED_6_3_B_BYTE_POS,
-	 LED_7_3_R_BYTE_POS,LED_7_3_G_BYTE_POS,LED_7_3_B_BYTE_POS,
-	 LED_0_4_R_BYTE_POS,LED_0_4_G_BYTE_POS,LED_0_4_B_BYTE_POS,
-	 LED_1_4_R_BYTE_POS,LED_1_4_G_BYTE_POS,LED_1_4_B_BYTE_POS,
-	 LED_2_4_R_BYTE_POS,LED_2_4_G_BYTE_POS,LED_2_4_B_BYTE_POS,
-	 LED_3_4_R_BYTE_POS,LED_3_4_G_BYTE_POS,LED_3_4_B_BYTE_POS,
-	 LED_4_4_R_BYTE_POS,LED_4_4_G_BYTE_POS,LED_4_4_B_BYTE_POS,
-	 LED_5_4_R_BYTE_POS,LED_5_4_G_BYTE_POS,LED_5_4_B_BYTE_POS,
-	 LED_6_4_R_BYTE_POS,LED_6_4_G_BYTE_POS,LED_6_4_B_BYTE_POS,
-	 LED_7_4_R_BYTE_POS,LED_7_4_G_BYTE_POS,LED_7_4_B_BYTE_POS,
-	 LED_0_5_R_BYTE_POS,LED_0_5_G_BYTE_POS,LED_0_5_B_BYTE_POS,
-	 LED_1_5_R_BYTE_POS,LED_1_5_G_BYTE_POS,LED_1_5_B_BYTE_POS,
-	 LED_2_5_R_BYTE_POS,LED_2_5_G_BYTE_POS,LED_2_5_B_BYTE_POS,
-	 LED_3_5_R_BYTE_POS,LED_3_5_G_BYTE_POS,LED_3_5_B_BYTE_POS,
-	 LED_4_5_R_BYTE_POS,LED_4_5_G_BYTE_POS,LED_4_5_B_BYTE_POS,
-	 LED_5_5_R_BYTE_POS,LED_5_5_G_BYTE_POS,LED_5_5_B_BYTE_POS,
-	 LED_6_5_R_BYTE_POS,LED_6_5_G_BYTE_POS,LED_6_5_B_BYTE_POS,
-	 LED_7_5_R_BYTE_POS,LED_7_5_G_BYTE_POS,LED_7_5_B_BYTE_POS,
-	 LED_0_6_R_BYTE_POS,LED_0_6_G_BYTE_POS,LED_0_6_B_BYTE_POS,
-	 LED_1_6_R_BYTE_POS,LED_1_6_G_BYTE_POS,LED_1_6_B_BYTE_POS,
-	 LED_2_6_R_BYTE_POS,LED_2_6_G_BYTE_POS,LED_2_6_B_BYTE_POS,
-	 LED_3_6_R_BYTE_POS,LED_3_6_G_BYTE_POS,LED_3_6_B_BYTE_POS,
-	 LED_4_6_R_BYTE_POS,LED_4_6_G_BYTE_POS,LED_4_6_B_BYTE_POS,
-	 LED_5_6_R_BYTE_POS,LED_5_6_G_BYTE_POS,LED_5_6_B_BYTE_POS,
-	 LED_6_6_R_BYTE_POS,LED_6_6_G_BYTE_POS,LED_6_6_B_BYTE_POS,
-	 LED_7_6_R_BYTE_POS,LED_7_6_G_BYTE_POS,LED_7_6_B_BYTE_POS,
-	 LED_0_7_R_BYTE_POS,LED_0_7_G_BYTE_POS,LED_0_7_B_BYTE_POS,
-	 LED_1_7_R_BYTE_POS,LED_1_7_G_BYTE_POS,LED_1_7_B_BYTE_POS,
-	 LED_2_7_R_BYTE_POS,LED_2_7_G_BYTE_POS,LED_2_7_B_BYTE_POS,
-	 LED_3_7_R_BYTE_POS,LED_3_7_G_BYTE_POS,LED_3_7_B_BYTE_POS,
-	 LED_4_7_R_BYTE_POS,LED_4_7_G_BYTE_POS,LED_4_7_B_BYTE_POS,
-	 LED_5_7_R_BYTE_POS,LED_5_7_G_BYTE_POS,LED_5_7_B_BYTE_POS,
-	 LED_6_7_R_BYTE_POS,LED_6_7_G_BYTE_POS,LED_6_7_B_BYTE_POS,
-	 LED_7_7_R_BYTE_POS,LED_7_7_G_BYTE_POS,LED_7_7_B_BYTE_POS }; //!< Lookuptable - Byte position used in process_bam_input()
+// Maps for look up - kept in flash, the SRAM is needed for the BAM tables
+// BIT MASK = STRING 0 - 5 TLC SPI, generated from TILE_LED_STRING()
+static const uint8_t lookup_bit_mask[] PROGMEM = {
+	BAM_REPEAT_PIXELS(BAM_LOOKUP_BIT_MASK) }; //!< Lookuptable - Bit position used in process_bam_input()
+
+// BYTE Pos = TLCOUT BIT NO., generated from TILE_LED_OUTPUT()
+static const uint8_t lookup_byte_pos[] PROGMEM = {
+	BAM_REPEAT_PIXELS(BAM_LOOKUP_BYTE_POS) }; //!< Lookuptable - Byte position used in process_bam_input()
+
+// BAM ORIENTATION
+static uint8_t bam_orient; //!< BAM_ORIENT_x, used in orient_bam_offset()
+static uint8_t bam_orient_ee EEMEM = BAM_ORIENT_NONE; //!< stored orientation, used in init_BAM()
 
 // BAM STEP COUNTER
 static volatile uint8_t bam_step; //!< bam step counter, used in ISR(TIMER_16_vect)
+static volatile uint8_t bam_cycle; //!< BAM cycle counter (~5mS), free running, used as timebase in get_bam_cycle()
+static volatile uint16_t bam_isr_max; //!< longest ISR(TIMER_16_vect) in timer ticks since clear_bam_isr_max()
+static volatile uint16_t bam_frame_count; //!< switched frames since reset, used in switch_bam_pointer()
+
+// BAM TABLE MEMORY - BAM sorted or for process use, .noinit => kept after a watchdog reset
+static volatile uint8_t bam_tbl_mem_1[BAM_MEM_SIZE] __attribute__((section(".noinit"))); //!< data source 32*8 Byte, used in transmit_BAM_step() or transmit_BAM_step()
+#ifndef BAM_SINGLE_BUFFER
+static volatile uint8_t bam_tbl_mem_2[BAM_MEM_SIZE] __attribute__((section(".noinit"))); //!< data source 32*8 Byte, used in transmit_BAM_step() or transmit_BAM_step()
+#endif
+static volatile uint16_t bam_noinit_signature __attribute__((section(".noinit"))); //!< BAM_NOINIT_SIGNATURE = tables valid, used in init_BAM()
+static volatile uint8_t bam_noinit_shown __attribute__((section(".noinit"))); //!< shown table, BAM_NOINIT_TBL_1 or BAM_NOINIT_TBL_2
+static volatile uint8_t bam_noinit_shown_inv __attribute__((section(".noinit"))); //!< ~bam_noinit_shown, used in init_BAM()
+static uint8_t bam_restored; //!< init_BAM() kept the shown frame
+
+// BAM SPLASH - frame after power up, BAM layout
+static uint8_t bam_splash_ee[BAM_MEM_SIZE] EEMEM; //!< stored splash frame, used in init_BAM()
+static uint8_t bam_splash_valid_ee EEMEM = BAM_SPLASH_NONE; //!< BAM_SPLASH_VALID = bam_splash_ee is complete
+static uint16_t bam_splash_pos = BAM_SPLASH_IDLE; //!< next byte to store, used in check_bam_splash()
+static uint8_t bam_splash_frame; //!< low byte of bam_frame_count at the store start
+static volatile uint8_t *volatile bam_tbl_mem;	//!< shown frame, points to bam_tbl_mem_1 or bam_tbl_mem_2
+static volatile uint8_t *volatile bam_tbl_proc; //!< source pointer used in process_bam_input(), points to bam_tbl_mem_1 or bam_tbl_mem_2, bam_tbl_mem_1 in single buffer mode
+static volatile uint8_t *volatile bam_tbl_out; //!< source pointer used in transmit_BAM_step(), bam_tbl_mem or bam_tbl_prev while fading
+static volatile uint8_t *volatile bam_tbl_prev; //!< previous frame while fading, used in ISR(TIMER_16_vect)
+
+// BAM FADE
+static volatile uint8_t bam_fade_cycles; //!< length of the crossfade in BAM cycles, 0 = off, used in switch_bam_pointer()
+static volatile uint8_t bam_fade_pos; //!< BAM cycles since the switch, used in ISR(TIMER_16_vect)
+static volatile uint16_t bam_fade_acc; //!< accumulator of the cycle pattern, up to 2*bam_fade_cycles-2, used in ISR(TIMER_16_vect)
+static volatile uint8_t bam_fading; //!< crossfade active, used in ISR(TIMER_16_vect)
+
+// BAM PRESENT - scheduled frame switch
+static volatile uint8_t bam_present_count; //!< frame counter of the wall, advanced by advance_bam_present()
+static volatile uint8_t bam_present_at; //!< counter value of the pending frame, used in advance_bam_present()
+static volatile uint8_t bam_present_pending; //!< bam_tbl_proc holds a scheduled frame, used in advance_bam_present()
+static volatile uint8_t bam_present_done; //!< the scheduled frame was switched, used in take_bam_present()
 
-// BAM TABLE MEMORY - BAM sorted or for process use
-static volatile uint8_t volatile bam_tbl_mem_1[BAM_MEM_SIZE]; //!< data source 32*8 Byte, used in transmit_BAM_step() or transmit_BAM_step()
-static volatile uint8_t volatile bam_tbl_mem_2[BAM_MEM_SIZE]; //!< data source 32*8 Byte, used in transmit_BAM_step() or transmit_BAM_step()
-static volatile uint8_t *volatile bam_tbl_mem;	//!< source pointer used in transmit_BAM_step(), points to bam_tbl_mem_1 or bam_tbl_mem_2
-static volatile uint8_t *volatile bam_tbl_proc; //!< source pointer used in process_bam_input(), points to bam_tbl_mem_1 or bam_tbl_mem_2
+#ifdef BAM_SINGLE_BUFFER
+// BAM STAGE - values on the way into the shown table, two halves: one fills, one is in the pass
+static tile_offset_t bam_stage_pos[2][BAM_STAGE_SIZE]; //!< mounted position of the value, used in write_bam_stage_plane()
+static uint8_t bam_stage_value[2][BAM_STAGE_SIZE]; //!< BAM value, used in write_bam_stage_plane()
+static uint8_t bam_stage_in; //!< half which fills, the other one is in the pass
+static uint8_t bam_stage_fill; //!< values in the filling half
+static uint8_t bam_stage_pass; //!< values in the pass, 0 = no pass running
+static uint8_t bam_stage_step; //!< next BAM step of the pass
+static uint8_t bam_stage_cycle; //!< BAM cycle of the pass, planes are written behind the transmit
+static uint16_t bam_stage_late; //!< values written at once because both halves were in use, used in get_bam_stage_late()
+#endif
 
 // PROTOTYPES
-static void init_TLC(void);
+static void save_bam_shown(void);
+static void sum_bam_table(volatile uint8_t *bam_tbl, uint16_t *sum);
+static uint8_t read_bam_value(volatile uint8_t *bam_tbl, tile_offset_t offset);
+static inline tile_offset_t orient_bam_offset(tile_offset_t offset);
+static inline void write_bam_value(uint8_t src, tile_offset_t pos);
+#ifdef BAM_SINGLE_BUFFER
+static void stage_bam_input(uint8_t src, tile_offset_t pos);
+static void flush_bam_stage(void);
+#endif
 
 
-/** \brief Initialize GPIO's, timer, variables initialize the TLC's */
-void init_BAM(void){
+/** \brief Initialize GPIO's, timer, variables initialize the TLC's
+ * \param  	uint8_t warm 	- watchdog reset, keep the shown frame if the tables are valid
+ *
+ * \details after a watchdog reset with valid signature the tables are not cleared,
+ *			\n after other resets the stored splash frame (or black) is loaded.
+ *			\n Step 0 of the frame is sent at the soft-SPI speed, BLANK stays set
+ *			\n until the first isr latches it, the timer is preloaded for it.
+ *			\n The TLC content after power up is never shown.
+ */
+void init_BAM(uint8_t warm){
 	uint16_t i=0;
 	// init BLANK
 	BLANK_PORT_DDR|=BLANK_PORT_DDR_MASK;
@@ -209,251 +156,101 @@ void init_BAM(void){
 	// init LAT 
 	LAT_PORT_DDR|=LAT_PORT_DDR_MASK;
 	LAT_PORT|=LAT_PORT_MASK;
-	// init BLANK
-	BLANK_PORT_DDR|=BLANK_PORT_DDR_MASK;
-	BLANK_PORT|=BLANK_PORT_MASK;
-	// init timer1 16-bit
+	// init timer1 16-bit, the first isr after BAM_TMR_STP_SIZE ticks
 	TIMER_16_CTRL_A=TIMER_16_CTRL_A_MASK;	
 	TIMER_16_CTRL_C=TIMER_16_CTRL_C_MASK;
+	TIMER_16_CNTR_H=BAM_TMR_RLD_STP_7_H;
+	TIMER_16_CNTR_L=BAM_TMR_RLD_STP_7_L;
 	TIMER_16_IMR = TIMER_16_IMR_MASK;
 	// init variables
-	for(i=0;i<BAM_MEM_SIZE;i++){
-		bam_tbl_mem_1[i] = 0;
-		bam_tbl_mem_2[i] = 0;
-	}
+	bam_restored = warm && bam_noinit_signature == BAM_NOINIT_SIGNATURE
+				&& (uint8_t)(bam_noinit_shown ^ bam_noinit_shown_inv) == 0xFF
+				&& (bam_noinit_shown == BAM_NOINIT_TBL_1 || bam_noinit_shown == BAM_NOINIT_TBL_2);
+#ifdef BAM_SINGLE_BUFFER
+	bam_restored = bam_restored && bam_noinit_shown == BAM_NOINIT_TBL_1;
 	bam_tbl_mem=bam_tbl_mem_1;
-	bam_tbl_proc=bam_tbl_mem_2;
+	bam_tbl_proc=bam_tbl_mem_1;
+	bam_stage_fill = 0;
+	bam_stage_pass = 0;
+	bam_stage_late = 0;
+#else
+	if(bam_restored && bam_noinit_shown == BAM_NOINIT_TBL_2){
+		bam_tbl_mem=bam_tbl_mem_2;
+		bam_tbl_proc=bam_tbl_mem_1;
+	} else {
+		bam_tbl_mem=bam_tbl_mem_1;
+		bam_tbl_proc=bam_tbl_mem_2;
+	}
+#endif
+	if(!bam_restored){
+		if(eeprom_read_byte(&bam_splash_valid_ee) == BAM_SPLASH_VALID){
+			eeprom_read_block((uint8_t *)bam_tbl_mem_1,bam_splash_ee,BAM_MEM_SIZE);
+		} else {
+			for(i=0;i<BAM_MEM_SIZE;i++){
+				bam_tbl_mem_1[i] = 0;
+			}
+		}
+#ifndef BAM_SINGLE_BUFFER
+		for(i=0;i<BAM_MEM_SIZE;i++){
+			bam_tbl_mem_2[i] = 0;
+		}
+#endif
+		bam_noinit_signature = BAM_NOINIT_SIGNATURE;
+	}
+	save_bam_shown();
+	bam_tbl_out=bam_tbl_mem;
+	bam_fade_cycles = 0;
+	bam_fading = 0;
 	bam_step = 0;
-	init_TLC();	
+	bam_duty = BAM_DUTY_MAX;
+	bam_orient = eeprom_read_byte(&bam_orient_ee);
+	if(bam_orient >= BAM_ORIENT_COUNT){
+		bam_orient = BAM_ORIENT_NONE;
+	}
+	// the first isr latches step 0 and releases BLANK
+	transmit_BAM_step();
 }
 
-/** \brief Initialize the TLC's, clear the the TLC buffer */
-static void init_TLC(void){
-	uint8_t bit_counter=0;
-	DATA_PORT = 0;
-	SCK_PORT =  0;
-	for(bit_counter=0;bit_counter<BAM_STRING_SIZE;bit_counter++){
-		DATA_PORT = 0;
-		SCK_PORT = SCK_PORT_MASK;
-		_delay_us(10);
-		SCK_PORT = ~SCK_PORT_MASK;
-		_delay_us(10);
-	}
-	LAT_PORT = LAT_SET;
-	_delay_us(100);
-	LAT_PORT = LAT_RESET;
-	BLANK_PORT &= ~BLANK_PORT_MASK;
+/** \brief frame of the last reset kept
+ * \return	1 = init_BAM() kept the shown frame
+ */
+uint8_t get_bam_restored(void){
+	return bam_restored;
+}
+
+/** \brief note the shown table for a watchdog reset */
+static void save_bam_shown(void){
+	uint8_t shown = (bam_tbl_mem == bam_tbl_mem_1) ? BAM_NOINIT_TBL_1 : BAM_NOINIT_TBL_2;
+	bam_noinit_shown = shown;
+	bam_noinit_shown_inv = ~shown;
 }
 
 /** \brief transmit the current BAM-Step to the TLCs
  *
  * \details	Bitbanging on the SoftSPI-GPIO's
- *  		Send's the current bam_tbl_mem (a block of 32 Bytes) to the TLC's
+ *  		Send's the current bam_tbl_out (a block of BAM_STRING_SIZE Bytes) to the TLC's
  *  		by toggling the Clock Port at about 2MHz and putting a stored byte
- *  		on the Output-GPIOport. A block of 32 Bytes is per any BAM step...
+ *  		on the Output-GPIOport. A block of BAM_STRING_SIZE Bytes is per any BAM step...
+ *			\n unrolled by BAM_REPEAT_OUTPUTS(), one BAM_TRANSMIT_BYTE() per TLC output
  *
  *	\note 	This must be interrupt free ! - Surround with cli()...sei() or put it in the timer isr
- *          \n Only 6 bits form a byte in the bam_tbl_mem  are used, because only 6 SOFTSPI's exist
+ *          \n Only TILE_STRINGS bits form a byte in the bam_tbl_mem are used, one per SOFTSPI
  */
+#define BAM_TRANSMIT_BYTE(n) \
+		SCK_PORT = 0; \
+		DATA_PORT = bam_tbl_ptr[n]; \
+		_delay_us(SOFT_SPI_L_TIME); \
+		SCK_PORT = SCK_PORT_MASK; \
+		_delay_us(SOFT_SPI_H_TIME);
 void transmit_BAM_step(void){
 		uint8_t volatile *bam_tbl_ptr;
 		// clear LAtch 
 		LAT_PORT = LAT_RESET;
 		// load ptr - bam step*32 + current bam_table , a lut is used...
-		bam_tbl_ptr= &bam_tbl_mem[bam_step_map[bam_step]];
-		// transmit next 32 Bytes
+		bam_tbl_ptr= &bam_tbl_out[bam_step_map[bam_step]];
+		// transmit next BAM_STRING_SIZE Bytes
 		// load DATA-byte then toggle SCK-PORT		
-		SCK_PORT =  0; // 0
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);		
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;		
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 1		
-		DATA_PORT = *bam_tbl_ptr;				
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 2
-	    DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-	    SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-	    _delay_us(SOFT_SPI_H_TIME);
-	    SCK_PORT = 0; //3
-	    DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-	    SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-	    _delay_us(SOFT_SPI_H_TIME);
-	    SCK_PORT = 0; // 4
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;		
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 5
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; //6
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 7
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 8
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 9
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT =  0; // 10
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 11
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 12
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 13
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 14
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; //15
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 16
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 17
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 18
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 19
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT =  0; // 20
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 21
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 22
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 23
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 24
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 25
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 26
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 27
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 28
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 29
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 30
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		bam_tbl_ptr++;
-		_delay_us(SOFT_SPI_H_TIME);
-		SCK_PORT = 0; // 31
-		DATA_PORT = *bam_tbl_ptr;
-		_delay_us(SOFT_SPI_L_TIME);
-		SCK_PORT = SCK_PORT_MASK;
-		_delay_us(SOFT_SPI_H_TIME);
+		BAM_REPEAT_OUTPUTS(BAM_TRANSMIT_BYTE)
 		SCK_PORT = 0;	
 }
 
@@ -463,42 +260,169 @@ void transmit_BAM_step(void){
  * \details	load the new timer reload value from bam_timer_map
  *     		prepare the TLC for the next step, this includes
  *     		the transmit_BAM_step()...
+ *			\n with a reduced duty the compare value from bam_blank_map
+ *			\n is loaded too, ISR(TIMER_16_CMP_vect) sets BLANK,
+ *			\n with BAM_DUTY_OFF BLANK is not released at all
+ *			\n while fading the source of every new BAM cycle is picked,
+ *			\n previous or new frame, the share of new cycles rises linear
+ *			\n every new BAM cycle increments bam_cycle
+ *			\n the run time from the reload to the end is kept in bam_isr_max,
+ *			\n the isr latency before the reload is not included
  *
  * \note	transmit_BAM_step() needs couple of 10µS
  */
 ISR(TIMER_16_vect){
+	PROFILER_ISR_BEGIN();
 	uint8_t bam_step_local = bam_step; // a local variable is faster!!!
+	uint16_t reload;
+	uint16_t isr_time;
 	// reload timer with new value
 	TIMER_16_CTRL_B = TIMER_16_STOP_TIMER;
 	TIMER_16_CNTR_H = bam_timer_map_h[bam_step_local];
    	TIMER_16_CNTR_L = bam_timer_map_l[bam_step_local];
+	if(bam_duty != BAM_DUTY_MAX){
+		TIMER_16_CMP_H = bam_blank_map_h[bam_step_local];
+		TIMER_16_CMP_L = bam_blank_map_l[bam_step_local];
+		TIMER_16_IFR = TIMER_16_IFR_CMP_MASK;
+	}
+	reload = ((uint16_t)bam_timer_map_h[bam_step_local]<<8) | bam_timer_map_l[bam_step_local];
 	bam_step_local++;
 	if(bam_step_local>=BAM_STEPS){
 		bam_step_local=0;				
+		bam_cycle++;
 	}
 	bam_step=bam_step_local;
-	// latch data
+	// crossfade - pick the frame of the next cycle
+	if(bam_step_local==0 && bam_fading){
+		uint8_t fade_pos = bam_fade_pos + 1;
+		uint16_t fade_acc = bam_fade_acc + fade_pos;
+		if(fade_pos >= bam_fade_cycles){
+			bam_tbl_out = bam_tbl_mem;
+			bam_fading = 0;
+		} else if(fade_acc >= bam_fade_cycles){
+			fade_acc -= bam_fade_cycles;
+			bam_tbl_out = bam_tbl_mem;
+		} else {
+			bam_tbl_out = bam_tbl_prev;
+		}
+		bam_fade_pos = fade_pos;
+		bam_fade_acc = fade_acc;
+	}
+	// latch data, release BLANK
 	LAT_PORT = LAT_PORT_MASK;		
+	if(bam_duty != BAM_DUTY_OFF){
+		BLANK_PORT &= ~BLANK_PORT_MASK;
+	}
 	// start timer
 	TIMER_16_CTRL_B = TIMER_16_START_TIMER;		
 	// prepare next step
 	transmit_BAM_step(); 	
+	// run time, the timer counts from the reload value (uint16_t also covers an overflow)
+	isr_time = TIMER_16_CNTR - reload;
+	if(isr_time > bam_isr_max){
+		bam_isr_max = isr_time;
+	}
+	PROFILER_ISR_END(PROFILER_BAM_ISR);
+}
+
+/** \brief ISR ( TIMER_16 COMPARE ) - end of the on time
+ * \param  	TIMER_16_CMP_vect ISR VECTOR
+ *
+ * \details	set BLANK for the rest of the BAM step, ISR(TIMER_16_vect) releases it
+ *
+ * \note	steps shorter than ISR(TIMER_16_vect) are blanked late,
+ *			\n the compare isr waits for it
+ */
+ISR(TIMER_16_CMP_vect){
+	BLANK_PORT |= BLANK_PORT_MASK;
+}
+
+/** \brief select the orientation of the mounted tile
+ * \param  	uint8_t orient 	- BAM_ORIENT_x, stored in the EEPROM
+ *
+ * \details the picture data stays canonical, the shown frame is kept
+ *			\n until the next frame
+ */
+void set_bam_orient(uint8_t orient){
+	if(orient < BAM_ORIENT_COUNT){
+		bam_orient = orient;
+		eeprom_update_byte(&bam_orient_ee,orient);
+	}
+}
+
+/** \brief orientation of the mounted tile
+ * \return	BAM_ORIENT_x
+ */
+uint8_t get_bam_orient(void){
+	return bam_orient;
+}
+
+/** \brief canonical picture position -> position of the mounted tile
+ * \param	tile_offset_t offset 	- position in the picture
+ * \return	position for lookup_byte_pos/lookup_bit_mask
+ *
+ * \details some 20 cycles for a rotated 8*8 tile, none for BAM_ORIENT_NONE
+ *  		transpose needs BAM_COLS == BAM_ROWS, BAM_ORIENT_COUNT keeps it out of
+ *  		bam_orient otherwise and the code is not built
+ */
+static inline tile_offset_t orient_bam_offset(tile_offset_t offset){
+	uint8_t px, c, x, y;
+	if(bam_orient == BAM_ORIENT_NONE){
+		return offset;
+	}
+#if BAM_COLS*BAM_ROWS*BAM_CHANNELS > 255
+	px = offset / BAM_CHANNELS;
+#else
+	px = ((uint16_t)offset*BAM_ORIENT_DIV3_MUL)>>BAM_ORIENT_DIV3_SHIFT;
+#endif
+	c = offset - px*BAM_CHANNELS;
+	x = px % BAM_COLS;
+	y = px / BAM_COLS;
+#if BAM_COLS == BAM_ROWS
+	if(bam_orient & BAM_ORIENT_TRANSPOSE){
+		uint8_t t = x;
+		x = y;
+		y = t;
+	}
+#endif
+	if(bam_orient & BAM_ORIENT_MIRROR_X){
+		x = BAM_COLS-1-x;
+	}
+	if(bam_orient & BAM_ORIENT_MIRROR_Y){
+		y = BAM_ROWS-1-y;
+	}
+	return (y*BAM_COLS+x)*BAM_CHANNELS + c;
 }
 
 /** \brief process the src byte into the BAM mem
  * \param  	uint8_t src 	- data to store
- * \param	uint8_t offset 	- position in the picture
+ * \param	tile_offset_t offset 	- position in the picture
  *
  * \details Processes every bit from input src data and put it in the right order
  *  		of the BAM Table (32 Byte per Cycle [TLC OUT 0-31])
  *  		And then put it in the right bit output byte (0 to 5 (SOFT SPI OUTPUT))
- *  		Also a remapping is used, this is done by the defines and the two lookuptable
+ *  		Also a remapping is used, this is done by the defines and the two lookuptable,
+ *  		the orientation of the tile first (orient_bam_offset())
+ *			\n in single buffer mode the value is staged, see check_bam_stage()
  *
- * \note	This function needs a couple of 10µS
+ * \note	This function needs a couple of µS, never waits
  */
-void process_bam_input(uint8_t src, uint8_t offset){
-	uint8_t byte_pos = lookup_byte_pos[offset]; // Byte Pos 0-31
-	uint8_t bit_mask = lookup_bit_mask[offset]; // String Position 0-5
+void process_bam_input(uint8_t src, tile_offset_t offset){
+	tile_offset_t pos = orient_bam_offset(offset); // mounted tile
+#ifdef BAM_SINGLE_BUFFER
+	stage_bam_input(src,pos);
+#else
+	write_bam_value(src,pos);
+#endif
+}
+
+/** \brief write a value into the BAM process table, all planes at once
+ * \param  	uint8_t src 	- data to store
+ * \param	tile_offset_t pos 	- position of the mounted tile
+ */
+static inline void write_bam_value(uint8_t src, tile_offset_t pos){
+	uint8_t byte_pos = pgm_read_byte(&lookup_byte_pos[pos]); // Byte Pos 0-31
+	uint8_t bit_mask = pgm_read_byte(&lookup_bit_mask[pos]); // String Position 0-5
 	uint8_t n_bit_mask = ~bit_mask;
 	uint8_t volatile *bam_tbl_ptr_local=&bam_tbl_proc[byte_pos];
 	// start with the first bit
@@ -551,13 +475,384 @@ void process_bam_input(uint8_t src, uint8_t offset){
 	} else {
 		*bam_tbl_ptr_local &= n_bit_mask;
 	}
-} 
+}
+
+#ifdef BAM_SINGLE_BUFFER
+/** \brief stage a value for the shown table
+ * \param  	uint8_t src 	- data to store
+ * \param	tile_offset_t pos 	- position of the mounted tile
+ *
+ * \details never waits: a full half starts its pass if the other one is done,
+ *			\n with both halves in use the value is written at once (all planes, may show
+ *			\n one mixed BAM cycle) and counted in bam_stage_late. A staged value of the
+ *			\n same position is replaced, its pass must not bring back the older one.
+ *			\n Tear-free up to BAM_STAGE_SIZE values per BAM cycle, see bam.h
+ */
+static void stage_bam_input(uint8_t src, tile_offset_t pos){
+	uint8_t i;
+	if(bam_stage_fill >= BAM_STAGE_SIZE){
+		check_bam_stage();
+	}
+	if(bam_stage_fill < BAM_STAGE_SIZE){
+		bam_stage_pos[bam_stage_in][bam_stage_fill] = pos;
+		bam_stage_value[bam_stage_in][bam_stage_fill] = src;
+		bam_stage_fill++;
+		return;
+	}
+	write_bam_value(src,pos);
+	for(i=0;i<BAM_STAGE_SIZE;i++){
+		if(bam_stage_pos[0][i] == pos){
+			bam_stage_value[0][i] = src;
+		}
+		if(bam_stage_pos[1][i] == pos){
+			bam_stage_value[1][i] = src;
+		}
+	}
+	if(bam_stage_late < 0xFFFF){
+		bam_stage_late++;
+	}
+}
+
+/** \brief write one plane of the values in the pass into the shown table
+ * \param  	uint8_t step 	- BAM step, transmitted for the current cycle already
+ *
+ * \details some 20 cycles per value
+ */
+static void write_bam_stage_plane(uint8_t step){
+	uint8_t volatile *bam_tbl_ptr_local=&bam_tbl_mem_1[bam_step_map[step]];
+	uint8_t half = bam_stage_in ^ 1;
+	uint8_t value_mask = BIT7_MASK >> step; // msb first, see BAM_TBL_POS_STEP_x
+	uint8_t byte_pos, bit_mask;
+	tile_offset_t pos;
+	uint8_t i;
+	for(i=0;i<bam_stage_pass;i++){
+		pos = bam_stage_pos[half][i];
+		byte_pos = pgm_read_byte(&lookup_byte_pos[pos]);
+		bit_mask = pgm_read_byte(&lookup_bit_mask[pos]);
+		if(bam_stage_value[half][i] & value_mask){
+			bam_tbl_ptr_local[byte_pos] |= bit_mask;
+		} else {
+			bam_tbl_ptr_local[byte_pos] &= ~bit_mask;
+		}
+	}
+}
+
+/** \brief move the staged values into the shown table, lock-step with the BAM isr
+ *
+ * \details	single buffer mode, called in the main loop and by a full stage.
+ *			\n A pass starts with the next BAM cycle, the plane of step k is written
+ *			\n after ISR(TIMER_16_vect) has transmitted step k. All planes of a value
+ *			\n change between the same two cycles, no cycle shows a mix of old and
+ *			\n new bits (e.g. 127 -> 128 flashing 255). New values fill the other half.
+ *
+ * \note	every plane has to be written within one BAM cycle (~5mS), a late plane
+ *			\n or a BAM reset by the sync shows one mixed cycle
+ */
+void check_bam_stage(void){
+	uint8_t cycle, step;
+	if(!bam_stage_pass){
+		if(!bam_stage_fill){
+			return;
+		}
+		bam_stage_pass = bam_stage_fill;
+		bam_stage_fill = 0;
+		bam_stage_in ^= 1;
+		bam_stage_step = 0;
+		bam_stage_cycle = bam_cycle + 1;
+	}
+	cli();
+	cycle = bam_cycle;
+	step = bam_step;
+	sei();
+	// step 0 of the pass cycle not transmitted yet
+	if((int8_t)(cycle - bam_stage_cycle) < 0){
+		return;
+	}
+	// late, the remaining planes at once
+	if(cycle != bam_stage_cycle){
+		step = BAM_STEPS-1;
+	}
+	while(bam_stage_step <= step){
+		write_bam_stage_plane(bam_stage_step);
+		bam_stage_step++;
+	}
+	if(bam_stage_step >= BAM_STEPS){
+		bam_stage_pass = 0;
+	}
+}
+
+/** \brief write every staged value into the shown table at once
+ *
+ * \details single buffer mode, before the shown table is read back or stored
+ *			\n (sums, shift, splash). No wait, a value may show one mixed BAM cycle,
+ *			\n the older half first.
+ *
+ * \note	2*BAM_STAGE_SIZE x some µS at most
+ */
+static void flush_bam_stage(void){
+	uint8_t half = bam_stage_in ^ 1;
+	uint8_t i;
+	for(i=0;i<bam_stage_pass;i++){
+		write_bam_value(bam_stage_value[half][i],bam_stage_pos[half][i]);
+	}
+	for(i=0;i<bam_stage_fill;i++){
+		write_bam_value(bam_stage_value[bam_stage_in][i],bam_stage_pos[bam_stage_in][i]);
+	}
+	bam_stage_pass = 0;
+	bam_stage_fill = 0;
+}
+#endif
+
+/** \brief values the single buffer stage wrote at once
+ * \return	values since reset, the host sent faster than BAM_STAGE_SIZE per BAM cycle,
+ *			0 without BAM_SINGLE_BUFFER
+ */
+uint16_t get_bam_stage_late(void){
+#ifdef BAM_SINGLE_BUFFER
+	return bam_stage_late;
+#else
+	return 0;
+#endif
+}
+
+/** \brief read a value back from a BAM table
+ * \param  	uint8_t *bam_tbl 	- bam_tbl_mem or bam_tbl_proc
+ * \param	tile_offset_t offset 	- position in the picture
+ * \return	BAM value, the inverse of process_bam_input()
+ */
+static uint8_t read_bam_value(volatile uint8_t *bam_tbl, tile_offset_t offset){
+	tile_offset_t pos = orient_bam_offset(offset);
+	uint8_t byte_pos = pgm_read_byte(&lookup_byte_pos[pos]);
+	uint8_t bit_mask = pgm_read_byte(&lookup_bit_mask[pos]);
+	uint8_t volatile *bam_tbl_ptr_local=&bam_tbl[byte_pos+BAM_STRING_SIZE*(BAM_STEPS-1)];
+	uint8_t value=0;
+	uint8_t i;
+	// msb first
+	for(i=0;i<BAM_STEPS;i++){
+		value<<=1;
+		if(*bam_tbl_ptr_local & bit_mask){
+			value|=BIT0_MASK;
+		}
+		bam_tbl_ptr_local-=BAM_STRING_SIZE;
+	}
+	return value;
+}
+
+/** \brief read a value of the shown frame
+ * \param	tile_offset_t offset 	- position in the picture
+ * \return	BAM value
+ *
+ * \details in single buffer mode a staged value is the newer one
+ */
+uint8_t read_bam_input(tile_offset_t offset){
+#ifdef BAM_SINGLE_BUFFER
+	tile_offset_t pos = orient_bam_offset(offset);
+	uint8_t half = bam_stage_in ^ 1;
+	uint8_t i;
+	for(i=bam_stage_fill;i>0;i--){
+		if(bam_stage_pos[bam_stage_in][i-1] == pos){
+			return bam_stage_value[bam_stage_in][i-1];
+		}
+	}
+	for(i=bam_stage_pass;i>0;i--){
+		if(bam_stage_pos[half][i-1] == pos){
+			return bam_stage_value[half][i-1];
+		}
+	}
+#endif
+	return read_bam_value(bam_tbl_mem,offset);
+}
+
+/** \brief copy the shown frame shifted by one pixel into the BAM process table
+ * \param  	uint8_t dir 	- BAM_SHIFT_LEFT, BAM_SHIFT_RIGHT, BAM_SHIFT_UP, BAM_SHIFT_DOWN
+ *
+ * \details	every pixel is read back from bam_tbl_mem and written with
+ *			\n process_bam_input(), the new edge is not written
+ *			\n the pixels are visited away from the source, a source pixel is read
+ *			\n before it is written (single buffer mode, the stage is flushed first)
+ *
+ * \note	This function needs about 1.5mS
+ */
+void shift_bam_frame(uint8_t dir){
+	uint8_t i,j,c;
+	uint8_t x,y;
+	uint8_t src_x,src_y;
+	tile_offset_t src_offset,dst_offset;
+#ifdef BAM_SINGLE_BUFFER
+	flush_bam_stage();
+#endif
+	for(j=0;j<BAM_ROWS;j++){
+		y = (dir == BAM_SHIFT_DOWN) ? BAM_ROWS-1-j : j;
+		for(i=0;i<BAM_COLS;i++){
+			x = (dir == BAM_SHIFT_RIGHT) ? BAM_COLS-1-i : i;
+			src_x = x;
+			src_y = y;
+			if(dir == BAM_SHIFT_LEFT){
+				src_x++;
+			} else if(dir == BAM_SHIFT_RIGHT){
+				src_x--;
+			} else if(dir == BAM_SHIFT_UP){
+				src_y++;
+			} else {
+				src_y--;
+			}
+			// the new edge, unsigned underflow is out of range too
+			if(src_x >= BAM_COLS || src_y >= BAM_ROWS){
+				continue;
+			}
+			src_offset = (src_y*BAM_COLS+src_x)*BAM_CHANNELS;
+			dst_offset = (y*BAM_COLS+x)*BAM_CHANNELS;
+			for(c=0;c<BAM_CHANNELS;c++){
+				process_bam_input(read_bam_value(bam_tbl_mem,src_offset+c),dst_offset+c);
+			}
+		}
+	}
+}
+
+/** \brief sum the values of a BAM table per channel
+ * \param  	uint8_t *bam_tbl 	- bam_tbl_mem or bam_tbl_proc
+ * \param  	uint16_t *sum 		- BAM_CHANNELS sums, for set_frame_power()
+ */
+static void sum_bam_table(volatile uint8_t *bam_tbl, uint16_t *sum){
+	tile_offset_t offset=0;
+	uint8_t c;
+	for(c=0;c<BAM_CHANNELS;c++){
+		sum[c]=0;
+	}
+	while(offset<BAM_COLS*BAM_ROWS*BAM_CHANNELS){
+		for(c=0;c<BAM_CHANNELS;c++){
+			sum[c]+=read_bam_value(bam_tbl,offset);
+			offset++;
+		}
+	}
+}
+
+/** \brief sum the values of the BAM process table per channel
+ * \param  	uint16_t *sum 	- BAM_CHANNELS sums, for set_frame_power()
+ */
+void sum_bam_proc(uint16_t *sum){
+#ifdef BAM_SINGLE_BUFFER
+	flush_bam_stage();
+#endif
+	sum_bam_table(bam_tbl_proc,sum);
+}
+
+/** \brief store the shown frame as splash frame or remove it
+ * \param  	uint8_t mode 	- BAM_SPLASH_STORE or BAM_SPLASH_CLEAR
+ *
+ * \details the splash is marked invalid at once, check_bam_splash() writes
+ *			\n the frame in the main loop (BAM_MEM_SIZE x 3.3mS)
+ */
+void store_bam_splash(uint8_t mode){
+	eeprom_update_byte(&bam_splash_valid_ee,BAM_SPLASH_NONE);
+	bam_splash_pos = (mode == BAM_SPLASH_STORE) ? 0 : BAM_SPLASH_IDLE;
+	bam_splash_frame = (uint8_t)bam_frame_count;
+}
+
+/** \brief write the splash frame, one byte per free EEPROM
+ *
+ * \details	called in the main loop, never waits for the EEPROM.
+ *			\n A frame switch during the store starts it again,
+ *			\n the valid mark is written after the last byte.
+ *			\n In single buffer mode the stage is flushed at the store start.
+ */
+void check_bam_splash(void){
+	if(bam_splash_pos == BAM_SPLASH_IDLE || !eeprom_is_ready()){
+		return;
+	}
+	if(bam_splash_frame != (uint8_t)bam_frame_count){
+		bam_splash_frame = (uint8_t)bam_frame_count;
+		bam_splash_pos = 0;
+	}
+#ifdef BAM_SINGLE_BUFFER
+	if(bam_splash_pos == 0){
+		flush_bam_stage();
+	}
+#endif
+	if(bam_splash_pos < BAM_MEM_SIZE){
+		eeprom_update_byte(&bam_splash_ee[bam_splash_pos],bam_tbl_mem[bam_splash_pos]);
+		bam_splash_pos++;
+	} else {
+		eeprom_update_byte(&bam_splash_valid_ee,BAM_SPLASH_VALID);
+		bam_splash_pos = BAM_SPLASH_IDLE;
+	}
+}
+
+/** \brief sum the values of the shown frame per channel
+ * \param  	uint16_t *sum 	- BAM_CHANNELS sums, e.g. for the frame kept by init_BAM()
+ */
+void sum_bam_mem(uint16_t *sum){
+	sum_bam_table(bam_tbl_mem,sum);
+}
+
+/** \brief fill the BAM process table with one color
+ * \param  	uint8_t red 	- BAM value red
+ * \param  	uint8_t green 	- BAM value green
+ * \param  	uint8_t blue 	- BAM value blue
+ *
+ * \details	every string carries one channel, so a BAM step is one byte
+ *			\n stored 32 times, e.g. 0x00 or 0x3F for black and white
+ *			\n in single buffer mode the staged values are dropped, the fill
+ *			\n goes straight into the shown table (may show one mixed BAM cycle)
+ *
+ * \note	This function needs about 30µS
+ */
+void fill_bam_proc(uint8_t red, uint8_t green, uint8_t blue){
+	uint8_t volatile *bam_tbl_ptr_local=bam_tbl_proc;
+	uint8_t bit_mask=BIT0_MASK;
+	uint8_t step_byte;
+	uint8_t i;
+#ifdef BAM_SINGLE_BUFFER
+	bam_stage_fill = 0;
+	bam_stage_pass = 0;
+#endif
+	while(bit_mask){
+		step_byte=0;
+		if(red & bit_mask){
+			step_byte|=BAM_STRING_MASK_R;
+		}
+		if(green & bit_mask){
+			step_byte|=BAM_STRING_MASK_G;
+		}
+		if(blue & bit_mask){
+			step_byte|=BAM_STRING_MASK_B;
+		}
+		for(i=0;i<BAM_STRING_SIZE;i++){
+			*bam_tbl_ptr_local++=step_byte;
+		}
+		bit_mask<<=1;
+	}
+}
+
+/** \brief copy the shown frame into the BAM process table
+ *
+ * \details base of a frame which differs in a few values from the shown one
+ *			\n nothing to do in single buffer mode, the process table is the shown one
+ */
+void copy_bam_mem(void){
+#ifndef BAM_SINGLE_BUFFER
+	uint8_t volatile *src=bam_tbl_mem;
+	uint8_t volatile *dst=bam_tbl_proc;
+	uint16_t i;
+	for(i=0;i<BAM_MEM_SIZE;i++){
+		*dst++=*src++;
+	}
+#endif
+}
 
 /** \brief switch the BAM/CALC-SRC-Pointer
  *
  * \details switch the bam_tbl_calc to bam_tbl_mem and vise versa
+ *			\n with bam_fade_cycles the old frame stays in bam_tbl_prev,
+ *			\n ISR(TIMER_16_vect) fades over to the new one
+ *			\n in single buffer mode: only counts the frame, no crossfade, the staged
+ *			\n values follow within 2 BAM cycles (check_bam_stage())
  */
 void switch_bam_pointer(void){
+#ifdef BAM_SINGLE_BUFFER
+	bam_frame_count++;
+	bam_tbl_out = bam_tbl_mem;
+#else
 	if(bam_tbl_mem == bam_tbl_mem_1){
 		bam_tbl_mem = bam_tbl_mem_2;
 		bam_tbl_proc = bam_tbl_mem_1;
@@ -565,6 +860,194 @@ void switch_bam_pointer(void){
 		bam_tbl_mem = bam_tbl_mem_1;
 		bam_tbl_proc = bam_tbl_mem_2;
 	}	
+	save_bam_shown();
+	bam_frame_count++;
+	if(bam_fade_cycles){
+		// the isr leaves the 16 bit accumulator alone until the fade starts
+		bam_fading = 0;
+		bam_tbl_prev = bam_tbl_proc;
+		bam_fade_pos = 0;
+		bam_fade_acc = 0;
+		bam_fading = 1;
+	} else {
+		bam_tbl_out = bam_tbl_mem;
+	}
+#endif
+}
+
+/** \brief set the length of the crossfade
+ * \param  	uint8_t cycles 	- BAM cycles from the previous to the new frame, 0 = off
+ *
+ * \note	ignored in single buffer mode, the previous frame is not kept
+ */
+void set_bam_fade(uint8_t cycles){
+#ifdef BAM_SINGLE_BUFFER
+	(void)cycles;
+#else
+	bam_fade_cycles = cycles;
+#endif
+}
+
+/** \brief stop a running crossfade
+ *
+ * \details show the new frame, bam_tbl_proc (= bam_tbl_prev) is free for new data
+ *			\n a scheduled frame which is not shown yet is dropped
+ *
+ * \note	call before the first write into bam_tbl_proc
+ */
+void stop_bam_fade(void){
+	bam_present_pending = 0;
+	bam_present_done = 0;
+	bam_fading = 0;
+	bam_tbl_out = bam_tbl_mem;
+}
+
+/** \brief switch the BAM pointer at a frame counter value
+ * \param  	uint8_t count 	- value of the frame counter
+ * \return	1 = switched now (count reached or passed), 0 = pending
+ *
+ * \details a pending frame is switched by advance_bam_present(),
+ *			\n a late frame is shown at once
+ *			\n in single buffer mode every frame is shown at once, there is no
+ *			\n second table to hold it
+ */
+uint8_t schedule_bam_pointer(uint8_t count){
+#ifdef BAM_SINGLE_BUFFER
+	(void)count;
+	switch_bam_pointer();
+	return 1;
+#else
+	uint8_t pending = 0;
+	// ISR(SPI_ISR_VECTOR) may advance the counter in between
+	cli();
+	if((int8_t)(count - bam_present_count) <= 0){
+		switch_bam_pointer();
+	} else {
+		bam_present_at = count;
+		bam_present_done = 0;
+		bam_present_pending = 1;
+		pending = 1;
+	}
+	sei();
+	return !pending;
+#endif
+}
+
+/** \brief advance the frame counter, switch a pending frame
+ *
+ * \details called in ISR(SPI_ISR_VECTOR) with the BAM-Cycle Reset, every tile
+ *			\n switches within the same BAM cycle
+ */
+void advance_bam_present(void){
+	uint8_t count = bam_present_count + 1;
+	bam_present_count = count;
+	if(bam_present_pending && count == bam_present_at){
+		bam_present_pending = 0;
+		switch_bam_pointer();
+		bam_present_done = 1;
+	}
+}
+
+/** \brief set the frame counter
+ * \param  	uint8_t count 	- new value, e.g. sent to all tiles after a reset of one
+ */
+void set_bam_present_count(uint8_t count){
+	bam_present_count = count;
+}
+
+/** \brief check for a switched scheduled frame
+ * \return	1 = switched since the last call
+ */
+uint8_t take_bam_present(void){
+	uint8_t done = bam_present_done;
+	if(done){
+		bam_present_done = 0;
+	}
+	return done;
+}
+
+/** \brief number of switched frames
+ * \return	frames since reset, wraps at 0xFFFF
+ */
+uint16_t get_bam_frame_count(void){
+	return bam_frame_count;
+}
+
+/** \brief longest ISR(TIMER_16_vect)
+ * \return	timer ticks (0.4µS) since clear_bam_isr_max()
+ */
+uint16_t get_bam_isr_max(void){
+	return bam_isr_max;
+}
+
+/** \brief restart the measurement of get_bam_isr_max() */
+void clear_bam_isr_max(void){
+	bam_isr_max = 0;
+}
+
+/** \brief current BAM duty
+ * \return	duty of set_bam_duty(), BAM_DUTY_MAX = no BLANK, BAM_DUTY_OFF = dark
+ */
+uint8_t get_bam_duty(void){
+	return bam_duty;
+}
+
+/** \brief BAM cycle counter
+ * \return	cycles since start, wraps at 256, one cycle = 255*BAM_TMR_STP_SIZE timer ticks (~5mS)
+ *
+ * \details timebase for the main loop, e.g. the rx timeout, differences as uint8_t
+ */
+uint8_t get_bam_cycle(void){
+	return bam_cycle;
+}
+
+/** \brief set the share of every BAM step the outputs are on
+ * \param  	uint8_t duty 	- on time = step time*duty/256, BAM_DUTY_MAX = always on,
+ *							  BAM_DUTY_OFF = dark
+ *
+ * \details calculates the compare value of every step into bam_blank_map
+ *			\n and enables the compare isr. The reload write blocks a compare match
+ *			\n at the reload value, so every on time is at least BAM_DUTY_ON_MIN ticks.
+ *			\n BAM_DUTY_OFF sets BLANK and keeps it, no compare isr.
+ *
+ * \note	the compare isr waits for ISR(TIMER_16_vect), on the short steps a small
+ *			\n on time is stretched to the end of that isr (see power.c)
+ *			\n the interrupt flag is restored, callable with interrupts disabled
+ */
+void set_bam_duty(uint8_t duty){
+	uint8_t i;
+	uint8_t sreg;
+	uint16_t reload;
+	uint16_t on_time;
+	if(duty == BAM_DUTY_MAX){
+		bam_duty = BAM_DUTY_MAX;
+		TIMER_16_IMR = TIMER_16_IMR_MASK;
+		return;
+	}
+	sreg = SREG;
+	cli();
+	if(duty == BAM_DUTY_OFF){
+		TIMER_16_IMR = TIMER_16_IMR_MASK;
+		bam_duty = BAM_DUTY_OFF;
+		BLANK_PORT |= BLANK_PORT_MASK;
+		SREG = sreg;
+		return;
+	}
+	for(i=0;i<BAM_STEPS;i++){
+		reload = ((uint16_t)bam_timer_map_h[i]<<8) | bam_timer_map_l[i];
+		on_time = (uint16_t)(((uint32_t)(BAM_TIMER_MAX - reload) * duty) >> 8);
+		if(on_time < BAM_DUTY_ON_MIN){
+			on_time = BAM_DUTY_ON_MIN;
+		}
+		bam_blank_map_h[i] = (uint8_t)((reload + on_time) >> 8);
+		bam_blank_map_l[i] = (uint8_t)(reload + on_time);
+	}
+	if(bam_duty == BAM_DUTY_MAX || bam_duty == BAM_DUTY_OFF){
+		TIMER_16_IFR = TIMER_16_IFR_CMP_MASK;
+	}
+	bam_duty = duty;
+	TIMER_16_IMR = TIMER_16_IMR_DIM_MASK;
+	SREG = sreg;
 }
 
 /** \brief Start BAM
@@ -0,0 +1,153 @@
+﻿/**
+ * \brief		animations stored in the flash
+ * \file		clip.c
+ * \author 		Rene Reinsch
+ * \date		18.10.2026
+ * \version 	Rev. 3.2
+ *
+ * \details		EXT_OP_CLIP plays a clip without further bus traffic, e.g. idle loops
+ *				\n or fallback content while other tiles show live picture data.
+ *				\n A clip frame holds only the values which differ from the previous frame,
+ *				\n the first frame differs from black. check_clip() builds the next frame in the
+ *				\n BAM process table (copy_bam_mem() + process_bam_input()) and switches the
+ *				\n BAM pointer when its BAM cycle is reached, so the timebase is the BAM itself.
+ *				\n Picture data or a command which shows a frame stops the clip.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "clip.h"
+#include "bam.h"
+#include "ingest.h"
+#include "power.h"
+
+// CLIP DATA
+static const uint8_t clip_orbit[] PROGMEM = {
+	28, 8,
+	1, CLIP_PX(0,0,INGEST_CH_B),0xFF,
+	2, CLIP_PX(1,0,INGEST_CH_B),0xFF, CLIP_PX(0,0,INGEST_CH_B),0x00,
+	2, CLIP_PX(2,0,INGEST_CH_B),0xFF, CLIP_PX(1,0,INGEST_CH_B),0x00,
+	2, CLIP_PX(3,0,INGEST_CH_B),0xFF, CLIP_PX(2,0,INGEST_CH_B),0x00,
+	2, CLIP_PX(4,0,INGEST_CH_B),0xFF, CLIP_PX(3,0,INGEST_CH_B),0x00,
+	2, CLIP_PX(5,0,INGEST_CH_B),0xFF, CLIP_PX(4,0,INGEST_CH_B),0x00,
+	2, CLIP_PX(6,0,INGEST_CH_B),0xFF, CLIP_PX(5,0,INGEST_CH_B),0x00,
+	2, CLIP_PX(7,0,INGEST_CH_B),0xFF, CLIP_PX(6,0,INGEST_CH_B),0x00,
+	2, CLIP_PX(7,1,INGEST_CH_B),0xFF, CLIP_PX(7,0,INGEST_CH_B),0x00,
+	2, CLIP_PX(7,2,INGEST_CH_B),0xFF, CLIP_PX(7,1,INGEST_CH_B),0x00,
+	2, CLIP_PX(7,3,INGEST_CH_B),0xFF, CLIP_PX(7,2,INGEST_CH_B),0x00,
+	2, CLIP_PX(7,4,INGEST_CH_B),0xFF, CLIP_PX(7,3,INGEST_CH_B),0x00,
+	2, CLIP_PX(7,5,INGEST_CH_B),0xFF, CLIP_PX(7,4,INGEST_CH_B),0x00,
+	2, CLIP_PX(7,6,INGEST_CH_B),0xFF, CLIP_PX(7,5,INGEST_CH_B),0x00,
+	2, CLIP_PX(7,7,INGEST_CH_B),0xFF, CLIP_PX(7,6,INGEST_CH_B),0x00,
+	2, CLIP_PX(6,7,INGEST_CH_B),0xFF, CLIP_PX(7,7,INGEST_CH_B),0x00,
+	2, CLIP_PX(5,7,INGEST_CH_B),0xFF, CLIP_PX(6,7,INGEST_CH_B),0x00,
+	2, CLIP_PX(4,7,INGEST_CH_B),0xFF, CLIP_PX(5,7,INGEST_CH_B),0x00,
+	2, CLIP_PX(3,7,INGEST_CH_B),0xFF, CLIP_PX(4,7,INGEST_CH_B),0x00,
+	2, CLIP_PX(2,7,INGEST_CH_B),0xFF, CLIP_PX(3,7,INGEST_CH_B),0x00,
+	2, CLIP_PX(1,7,INGEST_CH_B),0xFF, CLIP_PX(2,7,INGEST_CH_B),0x00,
+	2, CLIP_PX(0,7,INGEST_CH_B),0xFF, CLIP_PX(1,7,INGEST_CH_B),0x00,
+	2, CLIP_PX(0,6,INGEST_CH_B),0xFF, CLIP_PX(0,7,INGEST_CH_B),0x00,
+	2, CLIP_PX(0,5,INGEST_CH_B),0xFF, CLIP_PX(0,6,INGEST_CH_B),0x00,
+	2, CLIP_PX(0,4,INGEST_CH_B),0xFF, CLIP_PX(0,5,INGEST_CH_B),0x00,
+	2, CLIP_PX(0,3,INGEST_CH_B),0xFF, CLIP_PX(0,4,INGEST_CH_B),0x00,
+	2, CLIP_PX(0,2,INGEST_CH_B),0xFF, CLIP_PX(0,3,INGEST_CH_B),0x00,
+	2, CLIP_PX(0,1,INGEST_CH_B),0xFF, CLIP_PX(0,2,INGEST_CH_B),0x00 }; //!< CLIP_ORBIT, 1.1S per round
+
+static const uint8_t clip_pulse[] PROGMEM = {
+	4, 24,
+	4, CLIP_PX(3,3,INGEST_CH_R),0x10, CLIP_PX(4,3,INGEST_CH_R),0x10, CLIP_PX(3,4,INGEST_CH_R),0x10, CLIP_PX(4,4,INGEST_CH_R),0x10,
+	4, CLIP_PX(3,3,INGEST_CH_R),0x40, CLIP_PX(4,3,INGEST_CH_R),0x40, CLIP_PX(3,4,INGEST_CH_R),0x40, CLIP_PX(4,4,INGEST_CH_R),0x40,
+	4, CLIP_PX(3,3,INGEST_CH_R),0xFF, CLIP_PX(4,3,INGEST_CH_R),0xFF, CLIP_PX(3,4,INGEST_CH_R),0xFF, CLIP_PX(4,4,INGEST_CH_R),0xFF,
+	4, CLIP_PX(3,3,INGEST_CH_R),0x40, CLIP_PX(4,3,INGEST_CH_R),0x40, CLIP_PX(3,4,INGEST_CH_R),0x40, CLIP_PX(4,4,INGEST_CH_R),0x40 }; //!< CLIP_PULSE, 0.5S per beat
+
+static const uint8_t *const clip_map[CLIP_COUNT] PROGMEM = {
+	clip_orbit,
+	clip_pulse }; //!< Lookuptable - clip data per clip number, used in play_clip()
+
+static const uint8_t *clip_start; //!< header of the current clip
+static const uint8_t *clip_ptr; //!< next frame in the flash, used in check_clip()
+static uint8_t clip_frame; //!< number of the next frame
+static uint8_t clip_frames; //!< frames of the current clip
+static uint8_t clip_cycles; //!< BAM cycles per frame
+static uint8_t clip_mode; //!< CLIP_MODE_ONCE or CLIP_MODE_LOOP
+static uint8_t clip_cycle; //!< BAM cycle of the last frame switch
+static uint8_t clip_state = CLIP_STATE_IDLE; //!< CLIP_STATE_x, used in check_clip()
+
+/** \brief start a clip, the first frame is shown in the next main loop
+ * \param  	uint8_t clip 	- CLIP_x, CLIP_STOP or an unknown number stops the clip
+ * \param  	uint8_t mode 	- CLIP_MODE_ONCE or CLIP_MODE_LOOP
+ */
+void play_clip(uint8_t clip, uint8_t mode){
+	if(clip >= CLIP_COUNT){
+		stop_clip();
+		return;
+	}
+	clip_start = (const uint8_t *)pgm_read_word(&clip_map[clip]);
+	clip_frames = pgm_read_byte(&clip_start[CLIP_HEADER_FRAMES]);
+	clip_cycles = pgm_read_byte(&clip_start[CLIP_HEADER_CYCLES]);
+	clip_mode = mode;
+	clip_frame = 0;
+	clip_cycle = get_bam_cycle() - clip_cycles;
+	clip_state = CLIP_STATE_BUILD;
+}
+
+/** \brief stop the clip, the shown frame stays */
+void stop_clip(void){
+	clip_state = CLIP_STATE_IDLE;
+}
+
+/** \brief play the clip, called in the main loop
+ *
+ * \details the next frame is built right after a switch, the switch itself
+ *			\n waits for the BAM cycle, a late main loop does not stretch the clip
+ */
+void check_clip(void){
+	uint16_t sum[BAM_CHANNELS];
+	uint8_t entries;
+	uint8_t offset;
+	uint8_t value;
+	uint8_t px, x, y, c;
+	if(clip_state == CLIP_STATE_IDLE){
+		return;
+	}
+	if(clip_state == CLIP_STATE_BUILD){
+		// bam_tbl_proc may still be the source of a crossfade, a scheduled frame is dropped
+		stop_bam_fade();
+		if(clip_frame == 0){
+			fill_bam_proc(0,0,0);
+			clip_ptr = &clip_start[CLIP_HEADER_SIZE];
+		} else {
+			copy_bam_mem();
+		}
+		entries = pgm_read_byte(clip_ptr++);
+		while(entries--){
+			offset = pgm_read_byte(clip_ptr++);
+			value = pgm_read_byte(clip_ptr++);
+			// grid -> tile, pixels outside a smaller tile are skipped
+			px = offset / BAM_CHANNELS;
+			c = offset - px*BAM_CHANNELS;
+			x = px % CLIP_COLS;
+			y = px / CLIP_COLS;
+			if(x >= BAM_COLS || y >= BAM_ROWS){
+				continue;
+			}
+			process_bam_input(value,(y*BAM_COLS+x)*BAM_CHANNELS+c);
+		}
+		clip_frame++;
+		clip_state = CLIP_STATE_READY;
+	}
+	if((uint8_t)(get_bam_cycle()-clip_cycle) >= clip_cycles){
+		clip_cycle += clip_cycles;
+		sum_bam_proc(sum);
+		switch_bam_pointer();
+		set_frame_power(sum);
+		if(clip_frame < clip_frames){
+			clip_state = CLIP_STATE_BUILD;
+		} else if(clip_mode == CLIP_MODE_LOOP){
+			clip_frame = 0;
+			clip_state = CLIP_STATE_BUILD;
+		} else {
+			clip_state = CLIP_STATE_IDLE;
+		}
+	}
+}
@@ -0,0 +1,41 @@
+﻿/**
+ * \brief 	Clip Header - animations stored in the flash
+ * \file	clip.h
+ * \author  Rene Reinsch
+ * \date		18.10.2026
+ * \version  	Rev. 3.2
+ *
+ * \details Clip numbers, play modes, clip data layout
+ * 			\n Function prototypes definitions
+ */
+
+#include <avr/io.h>
+
+#ifndef CLIP_H_
+#define CLIP_H_
+// CLIPS - payload of EXT_OP_CLIP
+#define CLIP_ORBIT 0x00 // blue dot runs around the border
+#define CLIP_PULSE 0x01 // red 2x2 heartbeat in the center
+#define CLIP_COUNT 2
+#define CLIP_STOP 0xFF // keeps the shown frame
+// PLAY MODE
+#define CLIP_MODE_ONCE 0x00 // the last frame stays
+#define CLIP_MODE_LOOP 0x01
+// CLIP DATA - header, then per frame: entries, entries x (offset, BAM value)
+#define CLIP_HEADER_FRAMES 0
+#define CLIP_HEADER_CYCLES 1 // BAM cycles (~5mS) per frame
+#define CLIP_HEADER_SIZE 2
+// the clips are drawn on a CLIP_COLS*CLIP_ROWS grid, check_clip() maps it to the tile
+#define CLIP_COLS 8
+#define CLIP_ROWS 8
+#define CLIP_PX(x,y,c) (((y)*CLIP_COLS+(x))*BAM_CHANNELS+(c)) // offset of a value in the grid
+// PLAYER STATE
+#define CLIP_STATE_IDLE 0x00
+#define CLIP_STATE_BUILD 0x01 // next frame is built in the BAM process table
+#define CLIP_STATE_READY 0x02 // next frame waits for its BAM cycle
+// Prototypes
+extern void play_clip(uint8_t clip, uint8_t mode);
+extern void stop_clip(void);
+extern void check_clip(void);
+
+#endif /* CLIP_H_ */
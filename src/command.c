@@ -0,0 +1,353 @@
+﻿/**
+ * \brief		ext. commands on the picture data channel
+ * \file		command.c
+ * \author 		Rene Reinsch
+ * \date		18.10.2026
+ * \version 	Rev. 3.2
+ *
+ * \details		\b command transfer
+ *				\n ext. LATCH = 1 & 1 x SPI RX ISR, SPI byte = opcode
+ *				\n payload bytes, same LATCH handling as the picture data
+ *				\n 1 x LATCH => execute the command, back to EXT_OP_FRAME
+ *				\n\b opcodes
+ *				\n EXT_OP_FRAME - 192 byte picture data (default)
+ *				\n EXT_OP_GAMMA - 1 byte, select the gamma curve (GAMMA_LINEAR, GAMMA_2_2, GAMMA_2_8)
+ *				\n EXT_OP_CALIBRATE - 3 byte, R, G, B scale, stored in the EEPROM
+ *				\n EXT_OP_POWER_LIMIT - 2 byte, current limit in mA (high byte first), stored in the EEPROM
+ *				\n EXT_OP_CROSSFADE - 1 byte, crossfade length in BAM cycles (~5mS), 0 = off
+ *				\n EXT_OP_SHIFT - CMD_SHIFT_SIZE byte (25 on 8*8), BAM_SHIFT_x direction + R, G, B of
+ *				\n the new edge (left/right BAM_ROWS pixel top to bottom, up/down BAM_COLS pixel
+ *				\n left to right, padded to CMD_SHIFT_EDGE pixel), shows the result
+ *				\n EXT_OP_FILL - 3 byte, R, G, B, shows the tile in one color
+ *				\n EXT_OP_CLEAR - no payload, shows black
+ *				\n EXT_OP_PATTERN - 1 byte, shows a test pattern CMD_PATTERN_x
+ *				\n EXT_OP_TEXT - 10 byte, x, y (signed), R, G, B, background R, G, B, 2 ASCII
+ *				\n characters, shows the background with the text
+ *				\n EXT_OP_CRC - 1 byte, CRC_MODE_x of the picture data, stored in the EEPROM
+ *				\n EXT_OP_SELECT - 1 byte, tile ID or TILE_ID_BROADCAST
+ *				\n EXT_OP_SET_ID - 1 byte, new tile ID, stored in the EEPROM
+ *				\n EXT_OP_BRIGHTNESS - 1 byte, global brightness, 0xFF = full, 0 = dark
+ *				\n EXT_OP_CHAIN - 1 byte, tiles in the daisy-chain (1 = no chain), stored in the EEPROM
+ *				\n EXT_OP_PRESENT_AT - 1 byte, the next frame is shown when the frame counter
+ *				\n (BAM-Cycle Reset) reaches this value, see transceive_data.c
+ *				\n EXT_OP_PRESENT_COUNT - 1 byte, sets the frame counter, e.g. broadcast after power up
+ *				\n EXT_OP_TELEMETRY - TELEMETRY_SIZE byte, the tile sends the status block on MISO,
+ *				\n the received bytes are ignored, see telemetry.c
+ *				\n EXT_OP_SPLASH - 1 byte, BAM_SPLASH_STORE stores the shown frame as power up
+ *				\n frame in the EEPROM (~0.9S, the frame must not change meanwhile),
+ *				\n BAM_SPLASH_CLEAR = black after power up
+ *				\n EXT_OP_CLIP - 2 byte, CLIP_x, CLIP_MODE_x, plays a clip from the flash,
+ *				\n CLIP_STOP stops it, see clip.c
+ *				\n EXT_OP_EFFECT - 10 byte, type, period, color A, color B, region,
+ *				\n runs an effect on the tile, EFFECT_NONE stops it, see effect.c
+ *				\n EXT_OP_ORIENT - 1 byte, BAM_ORIENT_x rotation/mirroring of the mounted tile,
+ *				\n the picture data stays canonical, stored in the EEPROM, the transposing
+ *				\n ones (90°, 270°) are ignored on a tile with BAM_COLS != BAM_ROWS
+ *				\n EXT_OP_FRAME_YUV - 96 byte picture data YUV 4:2:0, handled like EXT_OP_FRAME
+ *				\n (CRC, present, timeout), see ingest.c for the byte order
+ *				\n\b addressing
+ *				\n every tile executes EXT_OP_SELECT, a tile with another ID ignores the following
+ *				\n frames and commands until the next EXT_OP_SELECT. After reset every tile is
+ *				\n selected, a single tile needs no EXT_OP_SELECT. Broadcast commands
+ *				\n (e.g. EXT_OP_BRIGHTNESS, EXT_OP_CLEAR) are sent once after
+ *				\n EXT_OP_SELECT TILE_ID_BROADCAST.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <avr/eeprom.h>
+#include "command.h"
+#include "ingest.h"
+#include "power.h"
+#include "bam.h"
+#include "text.h"
+#include "crc.h"
+#include "telemetry.h"
+#include "transceive_data.h"
+#include "clip.h"
+#include "effect.h"
+
+// PAYLOAD SIZE MAP
+static const tile_offset_t cmd_size_map[EXT_OP_COUNT] PROGMEM = {
+	RX_DATA_MAX_COUNT,
+	1,
+	INGEST_CHANNELS,
+	2,
+	1,
+	CMD_SHIFT_SIZE,
+	INGEST_CHANNELS,
+	0,
+	1,
+	CMD_TEXT_SIZE,
+	1,
+	1,
+	1,
+	1,
+	1,
+	1,
+	1,
+	TELEMETRY_SIZE,
+	1,
+	2,
+	EFFECT_PARAM_SIZE,
+	1,
+	INGEST_YUV_SIZE }; //!< Lookuptable - payload size per opcode, used in get_cmd_size()
+
+static uint8_t cmd_buffer[CMD_BUF_SIZE]; //!< payload of the current command, used in process_cmd_input() and execute_cmd()
+static uint8_t cmd_tile_id; //!< ID of this tile, used in execute_cmd()
+static uint8_t cmd_tile_id_ee EEMEM = TILE_ID_DEFAULT; //!< stored tile ID, used in init_cmd()
+static uint8_t cmd_selected; //!< following frames/commands are for this tile, used in check_valid_rx_data()
+
+// PROTOTYPES
+static void commit_cmd_frame(const uint16_t *sum);
+static void shift_cmd(void);
+static void fill_cmd(uint8_t red, uint8_t green, uint8_t blue);
+static void pattern_cmd(uint8_t pattern);
+static void text_cmd(void);
+
+/** \brief Initialize the tile ID from the EEPROM, the tile is selected */
+void init_cmd(void){
+	cmd_tile_id = eeprom_read_byte(&cmd_tile_id_ee);
+	if(cmd_tile_id == TILE_ID_BROADCAST){
+		cmd_tile_id = TILE_ID_DEFAULT;
+	}
+	cmd_selected = 1;
+}
+
+/** \brief tile addressed by the last EXT_OP_SELECT
+ * \return	1 = frames and commands are for this tile
+ */
+uint8_t get_cmd_selected(void){
+	return cmd_selected;
+}
+
+/** \brief ID of this tile
+ * \return	tile ID
+ */
+uint8_t get_tile_id(void){
+	return cmd_tile_id;
+}
+
+/** \brief payload size of a command
+ * \param  	uint8_t op 	- opcode < EXT_OP_COUNT
+ * \return	number of payload bytes before the execute LATCH
+ */
+tile_offset_t get_cmd_size(uint8_t op){
+#if RX_DATA_MAX_COUNT > 255
+	return pgm_read_word(&cmd_size_map[op]);
+#else
+	return pgm_read_byte(&cmd_size_map[op]);
+#endif
+}
+
+/** \brief store a payload byte
+ * \param  	uint8_t src 	- received byte
+ * \param	uint8_t pos 	- position in the payload
+ */
+void process_cmd_input(uint8_t src, uint8_t pos){
+	if(pos < CMD_BUF_SIZE){
+		cmd_buffer[pos] = src;
+	}
+}
+
+/** \brief execute a completely received command
+ * \param  	uint8_t op 	- opcode
+ *
+ * \details commands for other tiles are ignored, except EXT_OP_SELECT
+ */
+void execute_cmd(uint8_t op){
+	if(op == EXT_OP_SELECT){
+		cmd_selected = (cmd_buffer[0] == cmd_tile_id || cmd_buffer[0] == TILE_ID_BROADCAST);
+		return;
+	}
+	if(!cmd_selected){
+		return;
+	}
+	switch(op){
+		case EXT_OP_GAMMA:
+			set_gamma_curve(cmd_buffer[0]);
+			break;
+		case EXT_OP_CALIBRATE:
+			set_calibration(cmd_buffer);
+			break;
+		case EXT_OP_POWER_LIMIT:
+			set_power_limit(((uint16_t)cmd_buffer[0]<<8) | cmd_buffer[1]);
+			break;
+		case EXT_OP_CROSSFADE:
+			set_bam_fade(cmd_buffer[0]);
+			break;
+		case EXT_OP_SHIFT:
+			shift_cmd();
+			break;
+		case EXT_OP_FILL:
+			fill_cmd(ingest_byte(cmd_buffer[0],INGEST_CH_R),
+					 ingest_byte(cmd_buffer[1],INGEST_CH_G),
+					 ingest_byte(cmd_buffer[2],INGEST_CH_B));
+			break;
+		case EXT_OP_CLEAR:
+			fill_cmd(0,0,0);
+			break;
+		case EXT_OP_PATTERN:
+			pattern_cmd(cmd_buffer[0]);
+			break;
+		case EXT_OP_TEXT:
+			text_cmd();
+			break;
+		case EXT_OP_CRC:
+			set_crc_mode(cmd_buffer[0]);
+			break;
+		case EXT_OP_SET_ID:
+			if(cmd_buffer[0] != TILE_ID_BROADCAST){
+				cmd_tile_id = cmd_buffer[0];
+				eeprom_update_byte(&cmd_tile_id_ee,cmd_tile_id);
+			}
+			break;
+		case EXT_OP_BRIGHTNESS:
+			set_brightness(cmd_buffer[0]);
+			break;
+		case EXT_OP_CHAIN:
+			set_rx_chain_length(cmd_buffer[0]);
+			break;
+		case EXT_OP_PRESENT_AT:
+			set_rx_present_at(cmd_buffer[0]);
+			break;
+		case EXT_OP_PRESENT_COUNT:
+			set_bam_present_count(cmd_buffer[0]);
+			break;
+		case EXT_OP_SPLASH:
+			store_bam_splash(cmd_buffer[0]);
+			break;
+		case EXT_OP_CLIP:
+			stop_effect();
+			play_clip(cmd_buffer[0],cmd_buffer[1]);
+			break;
+		case EXT_OP_EFFECT:
+			stop_clip();
+			start_effect(cmd_buffer);
+			break;
+		case EXT_OP_ORIENT:
+			set_bam_orient(cmd_buffer[0]);
+			break;
+		default:
+			break;
+	}
+}
+
+/** \brief show the frame built in the BAM process table
+ * \param  	uint16_t *sum 	- sum of the BAM values per channel
+ *
+ * \details same as the end of a received frame, including the current limit
+ */
+static void commit_cmd_frame(const uint16_t *sum){
+	stop_clip();
+	stop_effect();
+	switch_bam_pointer();
+	set_frame_power(sum);
+}
+
+/** \brief EXT_OP_SHIFT - shift the shown frame and fill in the new edge
+ *
+ * \details only the direction and one edge are transmitted instead of the whole frame
+ */
+static void shift_cmd(void){
+	uint16_t sum[BAM_CHANNELS];
+	uint8_t dir = cmd_buffer[0];
+	uint8_t *edge = &cmd_buffer[1];
+	uint8_t i,c,n;
+	tile_offset_t offset;
+	if(dir > BAM_SHIFT_DOWN){
+		return;
+	}
+	stop_bam_fade();
+	shift_bam_frame(dir);
+	// a vertical shift brings in a row, a horizontal shift a column
+	n = (dir == BAM_SHIFT_UP || dir == BAM_SHIFT_DOWN) ? BAM_COLS : BAM_ROWS;
+	for(i=0;i<n;i++){
+		if(dir == BAM_SHIFT_LEFT){
+			offset = (i*BAM_COLS+BAM_COLS-1)*BAM_CHANNELS;
+		} else if(dir == BAM_SHIFT_RIGHT){
+			offset = (i*BAM_COLS)*BAM_CHANNELS;
+		} else if(dir == BAM_SHIFT_UP){
+			offset = ((BAM_ROWS-1)*BAM_COLS+i)*BAM_CHANNELS;
+		} else {
+			offset = i*BAM_CHANNELS;
+		}
+		for(c=0;c<BAM_CHANNELS;c++){
+			process_bam_input(ingest_byte(*edge,c),offset+c);
+			edge++;
+		}
+	}
+	sum_bam_proc(sum);
+	commit_cmd_frame(sum);
+}
+
+/** \brief EXT_OP_FILL / EXT_OP_CLEAR - show one color
+ * \param  	uint8_t red 	- BAM value red
+ * \param  	uint8_t green 	- BAM value green
+ * \param  	uint8_t blue 	- BAM value blue
+ *
+ * \details whole bytes per BAM step, a blackout needs some 10µS
+ */
+static void fill_cmd(uint8_t red, uint8_t green, uint8_t blue){
+	uint16_t sum[BAM_CHANNELS];
+	stop_bam_fade();
+	fill_bam_proc(red,green,blue);
+	sum[INGEST_CH_R] = (uint16_t)red*(BAM_COLS*BAM_ROWS);
+	sum[INGEST_CH_G] = (uint16_t)green*(BAM_COLS*BAM_ROWS);
+	sum[INGEST_CH_B] = (uint16_t)blue*(BAM_COLS*BAM_ROWS);
+	commit_cmd_frame(sum);
+}
+
+/** \brief EXT_OP_PATTERN - show a test pattern
+ * \param  	uint8_t pattern 	- CMD_PATTERN_CHECKER or CMD_PATTERN_GRADIENT
+ *
+ * \details the values are not corrected by the ingest stage
+ */
+static void pattern_cmd(uint8_t pattern){
+	uint16_t sum[BAM_CHANNELS];
+	uint8_t x,y;
+	tile_offset_t offset=0;
+	uint8_t red,green,blue;
+	if(pattern > CMD_PATTERN_GRADIENT){
+		return;
+	}
+	stop_bam_fade();
+	for(y=0;y<BAM_ROWS;y++){
+		for(x=0;x<BAM_COLS;x++){
+			if(pattern == CMD_PATTERN_CHECKER){
+				red = ((x^y) & 0x01) ? 0 : 0xFF;
+				green = red;
+				blue = red;
+			} else {
+				red = x*(0xFF/(BAM_COLS-1));
+				green = y*(0xFF/(BAM_ROWS-1));
+				blue = 0;
+			}
+			process_bam_input(red,offset++);
+			process_bam_input(green,offset++);
+			process_bam_input(blue,offset++);
+		}
+	}
+	sum_bam_proc(sum);
+	commit_cmd_frame(sum);
+}
+
+/** \brief EXT_OP_TEXT - show text on a background color
+ *
+ * \details 11 byte per text update instead of a 192 byte frame
+ */
+static void text_cmd(void){
+	uint16_t sum[BAM_CHANNELS];
+	uint8_t color[BAM_CHANNELS];
+	uint8_t c;
+	for(c=0;c<BAM_CHANNELS;c++){
+		color[c] = ingest_byte(cmd_buffer[2+c],c);
+	}
+	stop_bam_fade();
+	fill_bam_proc(ingest_byte(cmd_buffer[5],INGEST_CH_R),
+				  ingest_byte(cmd_buffer[6],INGEST_CH_G),
+				  ingest_byte(cmd_buffer[7],INGEST_CH_B));
+	draw_text_proc((int8_t)cmd_buffer[0],(int8_t)cmd_buffer[1],color,&cmd_buffer[8],CMD_TEXT_CHARS);
+	sum_bam_proc(sum);
+	commit_cmd_frame(sum);
+}
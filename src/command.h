@@ -0,0 +1,70 @@
+﻿/**
+ * \brief 	Command Header - ext. commands on the picture data channel
+ * \file	command.h
+ * \author  Rene Reinsch
+ * \date		18.10.2026
+ * \version  	Rev. 3.2
+ *
+ * \details Opcodes, payload sizes
+ * 			\n Function prototypes definitions
+ */
+
+#include <avr/io.h>
+#include "tile_config.h"
+
+#ifndef COMMAND_H_
+#define COMMAND_H_
+// EXT OPCODES - SPI byte of the RX-Buffer reset (ext. LATCH = 1 & 1 x SPI RX ISR)
+#define EXT_OP_FRAME 0x00 // picture data, also used for every unknown opcode
+#define EXT_OP_GAMMA 0x01 // payload: curve
+#define EXT_OP_CALIBRATE 0x02 // payload: R, G, B scale
+#define EXT_OP_POWER_LIMIT 0x03 // payload: mA high byte, mA low byte
+#define EXT_OP_CROSSFADE 0x04 // payload: BAM cycles
+#define EXT_OP_SHIFT 0x05 // payload: direction, CMD_SHIFT_EDGE pixel R, G, B of the new edge
+#define EXT_OP_FILL 0x06 // payload: R, G, B
+#define EXT_OP_CLEAR 0x07 // no payload
+#define EXT_OP_PATTERN 0x08 // payload: CMD_PATTERN_x
+#define EXT_OP_TEXT 0x09 // payload: x, y, R, G, B, background R, G, B, 2 characters
+#define EXT_OP_CRC 0x0A // payload: CRC_MODE_x
+#define EXT_OP_SELECT 0x0B // payload: tile ID, always executed
+#define EXT_OP_SET_ID 0x0C // payload: new tile ID
+#define EXT_OP_BRIGHTNESS 0x0D // payload: brightness
+#define EXT_OP_CHAIN 0x0E // payload: tiles in the chain
+#define EXT_OP_PRESENT_AT 0x0F // payload: frame counter value of the next frame
+#define EXT_OP_PRESENT_COUNT 0x10 // payload: new frame counter value
+#define EXT_OP_TELEMETRY 0x11 // TELEMETRY_SIZE bytes, status block on MISO
+#define EXT_OP_SPLASH 0x12 // payload: BAM_SPLASH_STORE or BAM_SPLASH_CLEAR
+#define EXT_OP_CLIP 0x13 // payload: CLIP_x, CLIP_MODE_x
+#define EXT_OP_EFFECT 0x14 // payload: EFFECT_PARAM_SIZE parameter block
+#define EXT_OP_ORIENT 0x15 // payload: BAM_ORIENT_x
+#define EXT_OP_FRAME_YUV 0x16 // picture data YUV 4:2:0, INGEST_YUV_SIZE byte
+#define EXT_OP_COUNT 0x17
+// TILE ID - stored in the EEPROM, erased EEPROM = TILE_ID_DEFAULT
+#define TILE_ID_DEFAULT 0x00
+#define TILE_ID_BROADCAST 0xFF // selects every tile, not usable as tile ID
+// TEST PATTERNS
+#define CMD_PATTERN_CHECKER 0x00 // white / black
+#define CMD_PATTERN_GRADIENT 0x01 // red rises to the right, green to the bottom
+// COMMAND PAYLOAD
+#if TILE_COLS > TILE_ROWS
+#define CMD_SHIFT_EDGE TILE_COLS // pixel of the longer edge, a shorter edge ignores the rest
+#else
+#define CMD_SHIFT_EDGE TILE_ROWS
+#endif
+#define CMD_SHIFT_SIZE (1+CMD_SHIFT_EDGE*TILE_CHANNELS) // 25 on 8*8
+#define CMD_TEXT_CHARS 2
+#define CMD_TEXT_SIZE (8+CMD_TEXT_CHARS)
+#if CMD_SHIFT_SIZE > CMD_TEXT_SIZE
+#define CMD_BUF_SIZE CMD_SHIFT_SIZE
+#else
+#define CMD_BUF_SIZE CMD_TEXT_SIZE
+#endif
+// Prototypes
+extern void init_cmd(void);
+extern uint8_t get_cmd_selected(void);
+extern uint8_t get_tile_id(void);
+extern tile_offset_t get_cmd_size(uint8_t op);
+extern void process_cmd_input(uint8_t src, uint8_t pos);
+extern void execute_cmd(uint8_t op);
+
+#endif /* COMMAND_H_ */
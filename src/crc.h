@@ -0,0 +1,30 @@
+﻿/**
+ * \brief 	CRC Header - frame check of the received picture data
+ * \file	crc.h
+ * \author  Rene Reinsch
+ * \date		18.10.2026
+ * \version  	Rev. 3.2
+ *
+ * \details Defines for the CRC modes
+ * 			\n Function prototypes definitions
+ */
+
+#include <avr/io.h>
+
+#ifndef CRC_H_
+#define CRC_H_
+// CRC MODES - selected by EXT_OP_CRC, stored in the EEPROM
+#define CRC_MODE_OFF 0x00 // commit LATCH byte is ignored (default)
+#define CRC_MODE_8 0x01 // commit LATCH byte = CRC-8 of the 192 picture bytes
+#define CRC_MODE_COUNT 0x02
+// CRC-8 - polynomial x^8+x^2+x+1 (0x07), init 0x00, not reflected
+#define CRC_8_INIT 0x00
+// Prototypes
+extern void init_crc(void);
+extern void set_crc_mode(uint8_t mode);
+extern uint8_t get_crc_mode(void);
+extern uint8_t crc_8_update(uint8_t crc, uint8_t src);
+extern void count_crc_error(void);
+extern uint16_t get_crc_error_count(void);
+
+#endif /* CRC_H_ */
@@ -0,0 +1,220 @@
+﻿/**
+ * \brief		procedural effects on the tile
+ * \file		effect.c
+ * \author 		Rene Reinsch
+ * \date		18.10.2026
+ * \version 	Rev. 3.2
+ *
+ * \details		EXT_OP_EFFECT starts an effect from a 10 byte parameter block
+ *				\n (type, period, color A, color B, region), so fades, alarms or an idle glow
+ *				\n need no picture data. check_effect() runs in the main loop, at most every
+ *				\n EFFECT_STEP_CYCLES BAM cycles it computes the phase in the period and
+ *				\n draws the region only if its color (or the chase pixel) changed:
+ *				\n copy_bam_mem() + the region pixels, fill_bam_proc() for the whole tile.
+ *				\n Worst case is a 8*8 region, some 100µS copy + 192 x process_bam_input().
+ *				\n The current limit needs the sum of the frame, it is taken once with
+ *				\n sum_bam_proc() at the first draw and then follows the region: a color
+ *				\n step adds (new - old) x region size, a chase step leaves it unchanged.
+ *				\n Pixels outside the region keep the shown frame.
+ *				\n Picture data or a command which shows a frame stops the effect.
+ */
+
+#include <avr/io.h>
+#include "effect.h"
+#include "bam.h"
+#include "ingest.h"
+#include "power.h"
+
+static uint8_t effect_type = EFFECT_NONE; //!< EFFECT_x, used in check_effect()
+static uint8_t effect_color_a[BAM_CHANNELS]; //!< BAM values of color A
+static uint8_t effect_color_b[BAM_CHANNELS]; //!< BAM values of color B
+static uint16_t effect_period; //!< BAM cycles per period
+static uint16_t effect_time; //!< BAM cycles in the period
+static uint8_t effect_cycle; //!< BAM cycle of the last update
+static uint8_t effect_x0, effect_y0; //!< top left pixel of the region
+static uint8_t effect_w, effect_h; //!< size of the region
+static uint8_t effect_shown[BAM_CHANNELS]; //!< color of the last draw
+static uint8_t effect_pos; //!< chase pixel of the last draw
+static uint8_t effect_drawn; //!< 0 = nothing drawn yet
+static uint16_t effect_sum[BAM_CHANNELS]; //!< sum of the drawn frame per channel, used in commit_effect_frame()
+
+// PROTOTYPES
+static uint8_t mix_effect(uint8_t a, uint8_t b, uint8_t phase);
+static void draw_effect_px(uint8_t pos, const uint8_t *color);
+static void draw_effect_region(const uint8_t *color);
+static void commit_effect_frame(void);
+
+/** \brief start an effect
+ * \param  	uint8_t *param 	- EFFECT_PARAM_SIZE byte parameter block
+ *
+ * \details the colors pass the ingest stage, an empty region or
+ *			\n an unknown type stops the effect
+ */
+void start_effect(const uint8_t *param){
+	uint8_t x1 = param[EFFECT_PARAM_REGION_MAX]>>4;
+	uint8_t y1 = param[EFFECT_PARAM_REGION_MAX] & 0x0F;
+	uint8_t c;
+	effect_x0 = param[EFFECT_PARAM_REGION_MIN]>>4;
+	effect_y0 = param[EFFECT_PARAM_REGION_MIN] & 0x0F;
+	if(x1 >= BAM_COLS){
+		x1 = BAM_COLS-1;
+	}
+	if(y1 >= BAM_ROWS){
+		y1 = BAM_ROWS-1;
+	}
+	effect_type = param[EFFECT_PARAM_TYPE];
+	if(effect_type >= EFFECT_COUNT || effect_x0 > x1 || effect_y0 > y1){
+		effect_type = EFFECT_NONE;
+		return;
+	}
+	effect_w = x1 - effect_x0 + 1;
+	effect_h = y1 - effect_y0 + 1;
+	for(c=0;c<BAM_CHANNELS;c++){
+		effect_color_a[c] = ingest_byte(param[EFFECT_PARAM_COLOR_A+c],c);
+		effect_color_b[c] = ingest_byte(param[EFFECT_PARAM_COLOR_B+c],c);
+	}
+	effect_period = (uint16_t)param[EFFECT_PARAM_PERIOD]*EFFECT_PERIOD_UNIT;
+	if(effect_period == 0){
+		effect_period = 1;
+	}
+	effect_time = 0;
+	effect_cycle = get_bam_cycle() - EFFECT_STEP_CYCLES;
+	effect_drawn = 0;
+	stop_bam_fade();
+}
+
+/** \brief stop the effect, the shown frame stays */
+void stop_effect(void){
+	effect_type = EFFECT_NONE;
+}
+
+/** \brief run the effect, called in the main loop */
+void check_effect(void){
+	uint8_t color[BAM_CHANNELS];
+	uint8_t elapsed = get_bam_cycle() - effect_cycle;
+	uint8_t phase;
+	uint8_t pos;
+	uint8_t c;
+	uint16_t size;
+	uint8_t done = 0;
+	if(effect_type == EFFECT_NONE || elapsed < EFFECT_STEP_CYCLES){
+		return;
+	}
+	effect_cycle += elapsed;
+	if(effect_drawn){
+		effect_time += elapsed;
+	}
+	if(effect_time >= effect_period){
+		if(effect_type == EFFECT_FADE){
+			effect_time = effect_period;
+			done = 1;
+		} else {
+			effect_time %= effect_period;
+		}
+	}
+	phase = ((uint32_t)effect_time<<8)/(effect_period+1);
+	if(effect_type == EFFECT_CHASE){
+		pos = ((uint16_t)phase*(effect_w*effect_h))>>8;
+		if(effect_drawn && pos == effect_pos){
+			return;
+		}
+		// bam_tbl_proc may still be the source of the last crossfade
+		stop_bam_fade();
+		copy_bam_mem();
+		if(!effect_drawn){
+			draw_effect_region(effect_color_a);
+		} else {
+			draw_effect_px(effect_pos,effect_color_a);
+		}
+		draw_effect_px(pos,effect_color_b);
+		if(!effect_drawn){
+			sum_bam_proc(effect_sum);
+		}
+		effect_pos = pos;
+	} else {
+		if(effect_type == EFFECT_BLINK){
+			phase = (phase < EFFECT_PHASE_HALF) ? 0 : 0xFF;
+		} else if(effect_type == EFFECT_PULSE){
+			phase = (phase < EFFECT_PHASE_HALF) ? phase<<1 : (0xFF-phase)<<1;
+		} else if(done){
+			phase = 0xFF;
+		}
+		for(c=0;c<BAM_CHANNELS;c++){
+			color[c] = mix_effect(effect_color_a[c],effect_color_b[c],phase);
+		}
+		if(effect_drawn && color[INGEST_CH_R] == effect_shown[INGEST_CH_R]
+				&& color[INGEST_CH_G] == effect_shown[INGEST_CH_G]
+				&& color[INGEST_CH_B] == effect_shown[INGEST_CH_B]){
+			return;
+		}
+		stop_bam_fade();
+		size = effect_w*effect_h;
+		if(size == BAM_COLS*BAM_ROWS){
+			fill_bam_proc(color[INGEST_CH_R],color[INGEST_CH_G],color[INGEST_CH_B]);
+			for(c=0;c<BAM_CHANNELS;c++){
+				effect_sum[c] = (uint16_t)color[c]*size;
+			}
+		} else {
+			copy_bam_mem();
+			draw_effect_region(color);
+			if(!effect_drawn){
+				sum_bam_proc(effect_sum);
+			} else {
+				for(c=0;c<BAM_CHANNELS;c++){
+					effect_sum[c] += (uint16_t)((int16_t)(color[c]-effect_shown[c])*size);
+				}
+			}
+		}
+		for(c=0;c<BAM_CHANNELS;c++){
+			effect_shown[c] = color[c];
+		}
+	}
+	effect_drawn = 1;
+	commit_effect_frame();
+	if(done){
+		effect_type = EFFECT_NONE;
+	}
+}
+
+/** \brief color between A and B
+ * \param  	uint8_t a 		- BAM value at phase 0
+ * \param  	uint8_t b 		- BAM value at phase 0xFF
+ * \param  	uint8_t phase 	- 0..0xFF
+ * \return	BAM value
+ */
+static uint8_t mix_effect(uint8_t a, uint8_t b, uint8_t phase){
+	if(phase == 0xFF){
+		return b;
+	}
+	return ((uint16_t)a*(0x100-phase) + (uint16_t)b*phase)>>8;
+}
+
+/** \brief draw one region pixel in the BAM process table
+ * \param  	uint8_t pos 	- pixel in the region, row by row
+ * \param  	uint8_t *color 	- R, G, B BAM values
+ */
+static void draw_effect_px(uint8_t pos, const uint8_t *color){
+	uint8_t x = effect_x0 + pos % effect_w;
+	uint8_t y = effect_y0 + pos / effect_w;
+	tile_offset_t offset = (y*BAM_COLS+x)*BAM_CHANNELS;
+	uint8_t c;
+	for(c=0;c<BAM_CHANNELS;c++){
+		process_bam_input(color[c],offset+c);
+	}
+}
+
+/** \brief draw the region in one color in the BAM process table
+ * \param  	uint8_t *color 	- R, G, B BAM values
+ */
+static void draw_effect_region(const uint8_t *color){
+	uint8_t pos;
+	for(pos=0;pos<effect_w*effect_h;pos++){
+		draw_effect_px(pos,color);
+	}
+}
+
+/** \brief show the BAM process table with its current limit (effect_sum) */
+static void commit_effect_frame(void){
+	switch_bam_pointer();
+	set_frame_power(effect_sum);
+}
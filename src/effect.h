@@ -0,0 +1,40 @@
+﻿/**
+ * \brief 	Effect Header - procedural effects on the tile
+ * \file	effect.h
+ * \author  Rene Reinsch
+ * \date		18.10.2026
+ * \version  	Rev. 3.2
+ *
+ * \details Effect types, parameter block layout, update rate
+ * 			\n Function prototypes definitions
+ */
+
+#include <avr/io.h>
+
+#ifndef EFFECT_H_
+#define EFFECT_H_
+// EFFECT TYPES
+#define EFFECT_NONE 0x00 // stops the effect, the shown frame stays
+#define EFFECT_FADE 0x01 // color A to color B once, B stays
+#define EFFECT_BLINK 0x02 // half period A, half period B
+#define EFFECT_PULSE 0x03 // A to B and back
+#define EFFECT_CHASE 0x04 // a B pixel runs over A, row by row
+#define EFFECT_COUNT 5
+// PARAMETER BLOCK - payload of EXT_OP_EFFECT
+#define EFFECT_PARAM_TYPE 0
+#define EFFECT_PARAM_PERIOD 1 // x EFFECT_PERIOD_UNIT BAM cycles, 0 = 1
+#define EFFECT_PARAM_COLOR_A 2 // R, G, B
+#define EFFECT_PARAM_COLOR_B 5 // R, G, B
+#define EFFECT_PARAM_REGION_MIN 8 // x<<4 | y, top left pixel
+#define EFFECT_PARAM_REGION_MAX 9 // x<<4 | y, bottom right pixel
+#define EFFECT_PARAM_SIZE 10
+#define EFFECT_PERIOD_UNIT 8 // BAM cycles (~41mS)
+// UPDATE - at most every EFFECT_STEP_CYCLES, unchanged frames are not drawn
+#define EFFECT_STEP_CYCLES 2 // ~10mS
+#define EFFECT_PHASE_HALF 0x80
+// Prototypes
+extern void start_effect(const uint8_t *param);
+extern void stop_effect(void);
+extern void check_effect(void);
+
+#endif /* EFFECT_H_ */
@@ -0,0 +1,197 @@
+﻿/**
+ * \brief		Ingest stage - transfer curves for the received picture data
+ * \file		ingest.c
+ * \author 		Rene Reinsch
+ * \date		18.10.2026
+ * \version 	Rev. 3.2
+ *
+ * \details		Every picture byte passes ingest_byte() before process_bam_input()
+ *				\n maps it into the BAM table. The gamma curves are kept in flash,
+ *				\n one LPM per byte, so the controllers can send the raw 8 bit values.
+ *				\n The curve output has the width of the BAM (BAM_STEPS bits), a deeper
+ *				\n BAM needs wider tables.
+ *				\n\b calibration
+ *				\n white balance / brightness of the tile, one scale per channel, stored
+ *				\n in the EEPROM and applied with one MUL after the curve. A 3*256 byte
+ *				\n table does not fit into the SRAM next to the two BAM tables.
+ *				\n\b YUV 4:2:0
+ *				\n 96 instead of 192 byte per frame, U and V come first in every 2*2 block,
+ *				\n so each Y byte gives a complete pixel at once and no frame buffer is needed.
+ *				\n The chroma terms are computed once per block (3 MUL), a Y byte costs
+ *				\n 3 adds/clamps + 3 x ingest_byte() + 3 x process_bam_input(), ~15µS,
+ *				\n well below the LATCH pause. The chroma bytes only store.
+ * \note		cost per byte, not measured, counted from the instruction sequence (20MHz):
+ *				\n GAMMA_LINEAR ~ 22 cycles / 1.1µS, curve ~ 28 cycles / 1.4µS incl. call
+ *				\n and calibration, independent of the src value, process_bam_input()
+ *				\n itself needs ~ 80 cycles. A build with PROFILER_ENABLE measures the whole
+ *				\n byte path in PROFILER_INGEST (3.2µS resolution).
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <avr/eeprom.h>
+#include "ingest.h"
+#include "bam.h"
+
+// GAMMA 2.2 - round(255*(i/255)^2.2)
+static const uint8_t gamma_2_2_map[256] PROGMEM = {
+	  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,
+	  1,  1,  1,  1,  1,  1,  1,  1,  1,  2,  2,  2,  2,  2,  2,  2,
+	  3,  3,  3,  3,  3,  4,  4,  4,  4,  5,  5,  5,  5,  6,  6,  6,
+	  6,  7,  7,  7,  8,  8,  8,  9,  9,  9, 10, 10, 11, 11, 11, 12,
+	 12, 13, 13, 13, 14, 14, 15, 15, 16, 16, 17, 17, 18, 18, 19, 19,
+	 20, 20, 21, 22, 22, 23, 23, 24, 25, 25, 26, 26, 27, 28, 28, 29,
+	 30, 30, 31, 32, 33, 33, 34, 35, 35, 36, 37, 38, 39, 39, 40, 41,
+	 42, 43, 43, 44, 45, 46, 47, 48, 49, 49, 50, 51, 52, 53, 54, 55,
+	 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71,
+	 73, 74, 75, 76, 77, 78, 79, 81, 82, 83, 84, 85, 87, 88, 89, 90,
+	 91, 93, 94, 95, 97, 98, 99,100,102,103,105,106,107,109,110,111,
+	113,114,116,117,119,120,121,123,124,126,127,129,130,132,133,135,
+	137,138,140,141,143,145,146,148,149,151,153,154,156,158,159,161,
+	163,165,166,168,170,172,173,175,177,179,181,182,184,186,188,190,
+	192,194,196,197,199,201,203,205,207,209,211,213,215,217,219,221,
+	223,225,227,229,231,234,236,238,240,242,244,246,248,251,253,255 }; //!< Lookuptable - gamma 2.2, used in ingest_byte()
+
+// GAMMA 2.8 - round(255*(i/255)^2.8)
+static const uint8_t gamma_2_8_map[256] PROGMEM = {
+	  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+	  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  1,  1,  1,
+	  1,  1,  1,  1,  1,  1,  1,  1,  1,  2,  2,  2,  2,  2,  2,  2,
+	  2,  3,  3,  3,  3,  3,  3,  3,  4,  4,  4,  4,  4,  5,  5,  5,
+	  5,  6,  6,  6,  6,  7,  7,  7,  7,  8,  8,  8,  9,  9,  9, 10,
+	 10, 10, 11, 11, 11, 12, 12, 13, 13, 13, 14, 14, 15, 15, 16, 16,
+	 17, 17, 18, 18, 19, 19, 20, 20, 21, 21, 22, 22, 23, 24, 24, 25,
+	 25, 26, 27, 27, 28, 29, 29, 30, 31, 32, 32, 33, 34, 35, 35, 36,
+	 37, 38, 39, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 50,
+	 51, 52, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 66, 67, 68,
+	 69, 70, 72, 73, 74, 75, 77, 78, 79, 81, 82, 83, 85, 86, 87, 89,
+	 90, 92, 93, 95, 96, 98, 99,101,102,104,105,107,109,110,112,114,
+	115,117,119,120,122,124,126,127,129,131,133,135,137,138,140,142,
+	144,146,148,150,152,154,156,158,160,162,164,167,169,171,173,175,
+	177,180,182,184,186,189,191,193,196,198,200,203,205,208,210,213,
+	215,218,220,223,225,228,231,233,236,239,241,244,247,249,252,255 }; //!< Lookuptable - gamma 2.8, used in ingest_byte()
+
+static const uint8_t *gamma_map; //!< selected curve in flash, 0 = GAMMA_LINEAR, used in ingest_byte()
+static uint8_t calib_scale[INGEST_CHANNELS]; //!< scale per channel, copy of calib_scale_ee, used in ingest_byte()
+static uint8_t calib_scale_ee[INGEST_CHANNELS] EEMEM = {
+	CALIB_SCALE_MAX,CALIB_SCALE_MAX,CALIB_SCALE_MAX }; //!< calibration of the tile, used in set_calibration()
+
+static const uint8_t yuv_px_map[INGEST_YUV_BLOCK] PROGMEM = {
+	0,
+	0,
+	0,
+	1,
+	BAM_COLS,
+	BAM_COLS+1 }; //!< Lookuptable - pixel in the 2*2 block per block byte, used in ingest_yuv()
+
+static int8_t yuv_u; //!< U - INGEST_YUV_CENTER of the current block
+static int16_t yuv_term[INGEST_CHANNELS]; //!< chroma part of R, G, B of the current block, used in ingest_yuv()
+static uint8_t yuv_byte; //!< byte in the block, INGEST_YUV_x
+static uint8_t yuv_px; //!< top left pixel of the block
+
+// PROTOTYPES
+static uint8_t clamp_yuv(int16_t value);
+
+/** \brief Initialize the ingest stage with the default curve and the stored calibration */
+void init_ingest(void){
+	set_gamma_curve(GAMMA_DEFAULT);
+	eeprom_read_block(calib_scale,calib_scale_ee,INGEST_CHANNELS);
+}
+
+/** \brief select the gamma curve
+ * \param  	uint8_t curve 	- GAMMA_LINEAR, GAMMA_2_2 or GAMMA_2_8
+ *
+ * \details unknown curves select GAMMA_LINEAR
+ */
+void set_gamma_curve(uint8_t curve){
+	if(curve == GAMMA_2_2){
+		gamma_map = gamma_2_2_map;
+	} else if(curve == GAMMA_2_8){
+		gamma_map = gamma_2_8_map;
+	} else {
+		gamma_map = 0;
+	}
+}
+
+/** \brief store and use a new calibration
+ * \param  	uint8_t *scale 	- R, G, B scale, CALIB_SCALE_MAX = no correction
+ *
+ * \note	the EEPROM is only written when the values changed
+ */
+void set_calibration(const uint8_t *scale){
+	uint8_t i;
+	for(i=0;i<INGEST_CHANNELS;i++){
+		calib_scale[i] = scale[i];
+	}
+	eeprom_update_block(calib_scale,calib_scale_ee,INGEST_CHANNELS);
+}
+
+/** \brief convert a received YUV 4:2:0 byte
+ * \param  	uint8_t src 	- received byte
+ * \param	tile_offset_t pos 	- position in the frame, 0 restarts the conversion
+ * \param	uint8_t *rgb 	- R, G, B BAM values of the pixel
+ * \return	offset of the pixel for process_bam_input(), INGEST_YUV_NONE for U and V
+ */
+tile_offset_t ingest_yuv(uint8_t src, tile_offset_t pos, uint8_t *rgb){
+	uint8_t byte;
+	tile_offset_t offset = INGEST_YUV_NONE;
+	int8_t v;
+	if(pos == 0){
+		yuv_byte = INGEST_YUV_U;
+		yuv_px = 0;
+	}
+	byte = yuv_byte;
+	if(byte == INGEST_YUV_U){
+		yuv_u = src - INGEST_YUV_CENTER;
+	} else if(byte == INGEST_YUV_V){
+		v = src - INGEST_YUV_CENTER;
+		yuv_term[INGEST_CH_R] = (INGEST_YUV_R_V*v)>>INGEST_YUV_SHIFT;
+		yuv_term[INGEST_CH_G] = -((INGEST_YUV_G_U*yuv_u + INGEST_YUV_G_V*v)>>INGEST_YUV_SHIFT);
+		yuv_term[INGEST_CH_B] = (INGEST_YUV_B_U*yuv_u)>>INGEST_YUV_SHIFT;
+	} else {
+		offset = (tile_offset_t)(yuv_px + pgm_read_byte(&yuv_px_map[byte]))*INGEST_CHANNELS;
+		rgb[INGEST_CH_R] = ingest_byte(clamp_yuv(src + yuv_term[INGEST_CH_R]),INGEST_CH_R);
+		rgb[INGEST_CH_G] = ingest_byte(clamp_yuv(src + yuv_term[INGEST_CH_G]),INGEST_CH_G);
+		rgb[INGEST_CH_B] = ingest_byte(clamp_yuv(src + yuv_term[INGEST_CH_B]),INGEST_CH_B);
+	}
+	byte++;
+	if(byte >= INGEST_YUV_BLOCK){
+		byte = INGEST_YUV_U;
+		yuv_px += 2;
+		// next block row, skip the bottom row of the blocks
+		if((yuv_px % BAM_COLS) == 0){
+			yuv_px += BAM_COLS;
+		}
+	}
+	yuv_byte = byte;
+	return offset;
+}
+
+/** \brief limit a converted value to 0..255
+ * \param  	int16_t value 	- Y + chroma term
+ * \return	0..255
+ */
+static uint8_t clamp_yuv(int16_t value){
+	if(value < 0){
+		return 0;
+	}
+	if(value > 0xFF){
+		return 0xFF;
+	}
+	return value;
+}
+
+/** \brief map a received picture byte to its BAM value
+ * \param  	uint8_t src 	- received byte
+ * \param	uint8_t channel - INGEST_CH_R, INGEST_CH_G or INGEST_CH_B
+ * \return	BAM value for process_bam_input()
+ */
+uint8_t ingest_byte(uint8_t src, uint8_t channel){
+	const uint8_t *map = gamma_map;
+	uint8_t value = src;
+	if(map != 0){
+		value = pgm_read_byte(&map[src]);
+	}
+	// value*(scale+1)/256 - scale 255 keeps the value
+	return (uint8_t)(((uint16_t)value*calib_scale[channel] + value) >> 8);
+}
@@ -0,0 +1,52 @@
+﻿/**
+ * \brief 	Ingest Header - transfer curves for the received picture data
+ * \file	ingest.h
+ * \author  Rene Reinsch
+ * \date		18.10.2026
+ * \version  	Rev. 3.2
+ *
+ * \details Defines for the selectable gamma curves and the calibration
+ * 			\n Function prototypes definitions
+ */
+
+#include <avr/io.h>
+#include "tile_config.h"
+
+#ifndef INGEST_H_
+#define INGEST_H_
+// GAMMA CURVES - selected by EXT_OP_GAMMA
+#define GAMMA_LINEAR 0x00 // no correction, src byte = BAM value
+#define GAMMA_2_2 0x01
+#define GAMMA_2_8 0x02
+#define GAMMA_COUNT 0x03
+// curve after reset, linear keeps controllers which correct themselves working
+#define GAMMA_DEFAULT GAMMA_LINEAR
+// CHANNELS - order of the picture data
+#define INGEST_CH_R 0
+#define INGEST_CH_G 1
+#define INGEST_CH_B 2
+#define INGEST_CHANNELS 3
+// CALIBRATION - scale per channel, out = in*(scale+1)/256, erased EEPROM = no correction
+#define CALIB_SCALE_MAX 0xFF
+// YUV 4:2:0 - EXT_OP_FRAME_YUV, 2*2 pixel blocks row by row: U, V, Y top left, top right, bottom left, bottom right
+#define INGEST_YUV_SIZE (TILE_COLS*TILE_ROWS*3/2) // 96 on the 8*8 tile
+#define INGEST_YUV_U 0
+#define INGEST_YUV_V 1
+#define INGEST_YUV_Y 2
+#define INGEST_YUV_BLOCK 6
+#define INGEST_YUV_NONE ((tile_offset_t)0xFFFF) // chroma byte, no pixel
+#define INGEST_YUV_CENTER 128
+// BT.601 full range, coefficients *64
+#define INGEST_YUV_R_V 90 // 1.402
+#define INGEST_YUV_G_U 22 // 0.344
+#define INGEST_YUV_G_V 46 // 0.714
+#define INGEST_YUV_B_U 113 // 1.772
+#define INGEST_YUV_SHIFT 6
+// Prototypes
+extern void init_ingest(void);
+extern void set_gamma_curve(uint8_t curve);
+extern void set_calibration(const uint8_t *scale);
+extern uint8_t ingest_byte(uint8_t src, uint8_t channel);
+extern tile_offset_t ingest_yuv(uint8_t src, tile_offset_t pos, uint8_t *rgb);
+
+#endif /* INGEST_H_ */
@@ -0,0 +1,119 @@
+﻿/**
+ * \brief		frame current estimation and limit
+ * \file		power.c
+ * \author 		Rene Reinsch
+ * \date		18.10.2026
+ * \version 	Rev. 3.2
+ *
+ * \details		check_valid_rx_data() sums the BAM values per channel while the
+ *				\n picture is received, at the frame switch set_frame_power() turns the
+ *				\n sums into the current of the frame. Above the limit the frame is
+ *				\n dimmed with the BAM duty (BLANK), the picture data is not touched.
+ *				\n current = sum(value*POWER_LED_MA)/255 per channel
+ *				\n The compare isr which sets BLANK waits for ISR(TIMER_16_vect), a step
+ *				\n shorter than that isr is on up to its end (some 50 ticks, one LSB step).
+ *				\n With a small duty this adds up to POWER_DUTY_LATENCY/255 of the full
+ *				\n on time, the limited duty keeps that free. A limit below it gives
+ *				\n BAM_DUTY_OFF, the frame is not shown rather than shown too bright.
+ *				\n The global brightness (EXT_OP_BRIGHTNESS) and the thermal derating use the
+ *				\n same BAM duty, the lowest of the duties is used.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <avr/eeprom.h>
+#include "power.h"
+#include "ingest.h"
+#include "bam.h"
+
+// LED CURRENT MAP
+static const uint8_t power_led_ma_map[INGEST_CHANNELS] PROGMEM = {
+	POWER_LED_MA_R,
+	POWER_LED_MA_G,
+	POWER_LED_MA_B }; //!< Lookuptable - mA per channel, used in set_frame_power()
+
+static uint16_t power_limit; //!< current limit in mA, used in set_frame_power()
+static uint16_t power_limit_ee EEMEM = POWER_LIMIT_NONE; //!< stored current limit, used in set_power_limit()
+static uint16_t frame_current; //!< estimated current of the shown frame in mA
+static uint8_t power_duty; //!< BAM duty of the current limit, used in apply_power_duty()
+static uint8_t power_brightness; //!< global brightness, used in apply_power_duty()
+static uint8_t power_thermal; //!< BAM duty of the thermal derating, used in apply_power_duty()
+
+// PROTOTYPES
+static void apply_power_duty(void);
+
+/** \brief Initialize the limit from the EEPROM */
+void init_power(void){
+	power_limit = eeprom_read_word(&power_limit_ee);
+	frame_current = 0;
+	power_duty = BAM_DUTY_MAX;
+	power_brightness = POWER_BRIGHTNESS_MAX;
+	power_thermal = BAM_DUTY_MAX;
+}
+
+/** \brief store and use a new current limit
+ * \param  	uint16_t limit 	- mA per tile, POWER_LIMIT_NONE = no limit
+ */
+void set_power_limit(uint16_t limit){
+	power_limit = limit;
+	eeprom_update_word(&power_limit_ee,limit);
+}
+
+/** \brief estimate the current of the new frame and set the BAM duty
+ * \param  	uint16_t *sum 	- sum of the BAM values per channel
+ *
+ * \note	called at the frame switch, needs a couple of 10µS (32 bit division)
+ */
+void set_frame_power(const uint16_t *sum){
+	uint8_t i;
+	uint32_t current = 0;
+	uint8_t duty = BAM_DUTY_MAX;
+	for(i=0;i<INGEST_CHANNELS;i++){
+		current += (uint32_t)sum[i] * pgm_read_byte(&power_led_ma_map[i]);
+	}
+	current /= 255;
+	if(current > power_limit){
+		duty = (uint8_t)(((uint32_t)power_limit * 255) / current);
+		duty = (duty > POWER_DUTY_LATENCY) ? duty - POWER_DUTY_LATENCY : BAM_DUTY_OFF;
+	}
+	frame_current = (uint16_t)current;
+	power_duty = duty;
+	apply_power_duty();
+}
+
+/** \brief set the global brightness
+ * \param  	uint8_t brightness 	- BAM duty, POWER_BRIGHTNESS_MAX = full
+ *
+ * \details keeps the current limit, not stored in the EEPROM
+ */
+void set_brightness(uint8_t brightness){
+	power_brightness = brightness;
+	apply_power_duty();
+}
+
+/** \brief set the BAM duty of the thermal derating
+ * \param  	uint8_t duty 	- BAM_DUTY_MAX = no derating
+ */
+void set_thermal_duty(uint8_t duty){
+	power_thermal = duty;
+	apply_power_duty();
+}
+
+/** \brief set the lowest duty of current limit, brightness and derating */
+static void apply_power_duty(void){
+	uint8_t duty = power_duty;
+	if(power_brightness < duty){
+		duty = power_brightness;
+	}
+	if(power_thermal < duty){
+		duty = power_thermal;
+	}
+	set_bam_duty(duty);
+}
+
+/** \brief estimated current of the shown frame
+ * \return	mA, without the limit
+ */
+uint16_t get_frame_current(void){
+	return frame_current;
+}
@@ -0,0 +1,35 @@
+﻿/**
+ * \brief 	Power Header - frame current estimation and limit
+ * \file	power.h
+ * \author  Rene Reinsch
+ * \date		18.10.2026
+ * \version  	Rev. 3.2
+ *
+ * \details Defines for the current model of the tile
+ * 			\n Function prototypes definitions
+ */
+
+#include <avr/io.h>
+
+#ifndef POWER_H_
+#define POWER_H_
+// LED CURRENT - mA of one TLC59281 output at full duty (IREF resistor)
+#define POWER_LED_MA_R 20
+#define POWER_LED_MA_G 20
+#define POWER_LED_MA_B 20
+// CURRENT LIMIT - mA per tile, erased EEPROM = no limit
+#define POWER_LIMIT_NONE 0xFFFF
+// BRIGHTNESS - global BAM duty, selected by EXT_OP_BRIGHTNESS
+#define POWER_BRIGHTNESS_MAX 0xFF
+// LATENCY - duty units (1/255) the limited frame keeps free, every BAM step may stay on
+// until the end of ISR(TIMER_16_vect), about one LSB step (BAM_TMR_STP_SIZE)
+#define POWER_DUTY_LATENCY 8
+// Prototypes
+extern void init_power(void);
+extern void set_power_limit(uint16_t limit);
+extern void set_frame_power(const uint16_t *sum);
+extern void set_brightness(uint8_t brightness);
+extern void set_thermal_duty(uint8_t duty);
+extern uint16_t get_frame_current(void);
+
+#endif /* POWER_H_ */
@@ -0,0 +1,188 @@
+﻿/**
+ * \brief		run time of the isr and the frame path
+ * \file		profiler.c
+ * \author 		Rene Reinsch
+ * \date		18.10.2026
+ * \version 	Rev. 3.2
+ *
+ * \details		timer 0 runs free at 0.4µS for the isr probes, timer 2 at 3.2µS for the
+ *				\n main loop probes, PROFILER_x_BEGIN() takes the timer value,
+ *				\n PROFILER_x_END() adds the difference to min/max/mean and the histogram
+ *				\n of the probe. The values stay in the SRAM, read them with debugWIRE or the
+ *				\n get_profiler_x() functions.
+ *				\n The isr do not nest, their samples are the run time from the first to the last
+ *				\n statement (without the isr entry), an isr sample has to stay below 102µS.
+ *				\n The isr time within a main loop sample is subtracted, a main loop sample is
+ *				\n the run time of the path itself.
+ *				\n A main loop sample above 819µS ends in PROFILER_BIN_OVF.
+ *				\n Only compiled with PROFILER_ENABLE, costs a few µS per probe.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "profiler.h"
+
+#ifdef PROFILER_ENABLE
+
+static uint8_t profiler_min[PROFILER_PROBES]; //!< shortest run time in ticks
+static uint8_t profiler_max[PROFILER_PROBES]; //!< longest run time in ticks, 0xFF = overflow
+static uint16_t profiler_count[PROFILER_PROBES]; //!< samples in profiler_sum
+static uint32_t profiler_sum[PROFILER_PROBES]; //!< sum of the run times for the mean
+static uint16_t profiler_hist[PROFILER_PROBES][PROFILER_BINS]; //!< histogram, saturates at 0xFFFF
+static volatile uint16_t profiler_isr_ticks; //!< run time of all isr samples in isr ticks, used in profiler_end_main()
+static uint16_t profiler_main_isr_ticks; //!< profiler_isr_ticks at the start of the main loop sample
+
+// PROTOTYPES
+static void profiler_add(uint8_t probe, uint16_t ticks);
+
+/** \brief Initialize and start timer 0 and timer 2, clear the values */
+void init_profiler(void){
+	PROFILER_CTRL_A = PROFILER_CTRL_A_MASK;
+	PROFILER_CTRL_B = PROFILER_CTRL_B_MASK;
+	PROFILER_MAIN_CTRL_A = PROFILER_MAIN_CTRL_A_MASK;
+	PROFILER_MAIN_CTRL_B = PROFILER_MAIN_CTRL_B_MASK;
+	clear_profiler();
+}
+
+/** \brief clear the values of all probes */
+void clear_profiler(void){
+	uint8_t i,bin;
+	uint8_t sreg = SREG;
+	cli();
+	for(i=0;i<PROFILER_PROBES;i++){
+		profiler_min[i] = 0xFF;
+		profiler_max[i] = 0;
+		profiler_count[i] = 0;
+		profiler_sum[i] = 0;
+		for(bin=0;bin<PROFILER_BINS;bin++){
+			profiler_hist[i][bin] = 0;
+		}
+	}
+	SREG = sreg;
+}
+
+/** \brief add a sample
+ * \param  	uint8_t probe 	- PROFILER_x
+ * \param  	uint16_t ticks 	- run time, above 0xFF = overflow
+ */
+static void profiler_add(uint8_t probe, uint16_t ticks){
+	uint8_t bin;
+	if(ticks > 0xFF){
+		ticks = 0xFF;
+	}
+	bin = (uint8_t)ticks >> PROFILER_BIN_SHIFT;
+	if(bin > PROFILER_BIN_OVF){
+		bin = PROFILER_BIN_OVF;
+	}
+	if(ticks < profiler_min[probe]){
+		profiler_min[probe] = (uint8_t)ticks;
+	}
+	if(ticks > profiler_max[probe]){
+		profiler_max[probe] = (uint8_t)ticks;
+	}
+	if(profiler_count[probe] < 0xFFFF){
+		profiler_count[probe]++;
+		profiler_sum[probe] += ticks;
+	}
+	if(profiler_hist[probe][bin] < 0xFFFF){
+		profiler_hist[probe][bin]++;
+	}
+}
+
+/** \brief start of an isr sample
+ * \return	timer value
+ */
+uint8_t profiler_begin(void){
+	return PROFILER_TIMER;
+}
+
+/** \brief end of an isr sample
+ * \param  	uint8_t probe 	- PROFILER_x
+ * \param  	uint8_t t0 		- value of profiler_begin()
+ */
+void profiler_end(uint8_t probe, uint8_t t0){
+	uint8_t ticks = PROFILER_TIMER - t0;
+	profiler_add(probe,ticks);
+	profiler_isr_ticks += ticks;
+}
+
+/** \brief start of a main loop sample
+ * \return	timer value
+ */
+uint8_t profiler_begin_main(void){
+	uint8_t t0;
+	cli();
+	PROFILER_MAIN_IFR = PROFILER_MAIN_IFR_OVF_MASK;
+	t0 = PROFILER_MAIN_TIMER;
+	profiler_main_isr_ticks = profiler_isr_ticks;
+	sei();
+	return t0;
+}
+
+/** \brief end of a main loop sample
+ * \param  	uint8_t probe 	- PROFILER_x
+ * \param  	uint8_t t0 		- value of profiler_begin_main()
+ *
+ * \details the timer passed t0 again if the overflow flag is set and t1 >= t0
+ */
+void profiler_end_main(uint8_t probe, uint8_t t0){
+	uint8_t t1;
+	uint16_t ticks;
+	uint16_t isr_ticks;
+	cli();
+	t1 = PROFILER_MAIN_TIMER;
+	isr_ticks = (uint16_t)(profiler_isr_ticks - profiler_main_isr_ticks) >> PROFILER_MAIN_ISR_SHIFT;
+	if((PROFILER_MAIN_IFR & PROFILER_MAIN_IFR_OVF_MASK) && t1 >= t0){
+		ticks = 0x100;
+	} else {
+		ticks = (uint8_t)(t1 - t0);
+		ticks = (ticks > isr_ticks) ? ticks - isr_ticks : 0;
+	}
+	profiler_add(probe,ticks);
+	sei();
+}
+
+/** \brief shortest run time
+ * \param  	uint8_t probe 	- PROFILER_x
+ * \return	ticks (0.4µS isr probes, 3.2µS main loop probes)
+ */
+uint8_t get_profiler_min(uint8_t probe){
+	return profiler_min[probe];
+}
+
+/** \brief longest run time
+ * \param  	uint8_t probe 	- PROFILER_x
+ * \return	ticks (0.4µS isr probes, 3.2µS main loop probes), 0xFF = overflow
+ */
+uint8_t get_profiler_max(uint8_t probe){
+	return profiler_max[probe];
+}
+
+/** \brief mean run time
+ * \param  	uint8_t probe 	- PROFILER_x
+ * \return	ticks (0.4µS isr probes, 3.2µS main loop probes), overflows count as 0xFF
+ */
+uint8_t get_profiler_mean(uint8_t probe){
+	uint8_t mean = 0;
+	cli();
+	if(profiler_count[probe]){
+		mean = (uint8_t)(profiler_sum[probe] / profiler_count[probe]);
+	}
+	sei();
+	return mean;
+}
+
+/** \brief histogram
+ * \param  	uint8_t probe 	- PROFILER_x
+ * \param  	uint8_t bin 	- 0 .. PROFILER_BINS-1
+ * \return	samples in the bin
+ */
+uint16_t get_profiler_bin(uint8_t probe, uint8_t bin){
+	uint16_t samples;
+	cli();
+	samples = profiler_hist[probe][bin];
+	sei();
+	return samples;
+}
+
+#endif /* PROFILER_ENABLE */
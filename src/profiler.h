@@ -0,0 +1,72 @@
+﻿/**
+ * \brief 	Profiler Header - run time of the isr and the frame path
+ * \file	profiler.h
+ * \author  Rene Reinsch
+ * \date		18.10.2026
+ * \version  	Rev. 3.2
+ *
+ * \details Defines for timer 0, probes and histogram
+ *			\n PROFILER_x macros, empty without PROFILER_ENABLE
+ * 			\n Function prototypes definitions
+ */
+
+#include <avr/io.h>
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+// PROFILER - build with -DPROFILER_ENABLE (Debug configuration), release builds carry no profiler code
+// ISR PROBES - timer 0 8-bit, free running, clock div 8 => 0.4µS per tick, 102µS range
+#define PROFILER_TIMER TCNT0
+#define PROFILER_CTRL_A TCCR0A
+#define PROFILER_CTRL_B TCCR0B
+#define PROFILER_CTRL_A_MASK 0x00 // normal operation
+#define PROFILER_CTRL_B_MASK (1<<CS01) // Clock div 8
+// MAIN LOOP PROBES - timer 2 8-bit, free running, clock div 64 => 3.2µS per tick, 819µS range
+#define PROFILER_MAIN_TIMER TCNT2
+#define PROFILER_MAIN_CTRL_A TCCR2A
+#define PROFILER_MAIN_CTRL_B TCCR2B
+#define PROFILER_MAIN_CTRL_A_MASK 0x00 // normal operation
+#define PROFILER_MAIN_CTRL_B_MASK (1<<CS22) // Clock div 64
+#define PROFILER_MAIN_IFR TIFR2
+#define PROFILER_MAIN_IFR_OVF_MASK (1<<TOV2)
+#define PROFILER_MAIN_ISR_SHIFT 3 // isr ticks (0.4µS) -> main loop ticks (3.2µS)
+// PROBES
+#define PROFILER_BAM_ISR 0 // ISR(TIMER_16_vect)
+#define PROFILER_LATCH_ISR 1 // ISR(PIN_CHANGE_ISR_VECTOR)
+#define PROFILER_SPI_ISR 2 // ISR(SPI_ISR_VECTOR)
+#define PROFILER_COMMIT 3 // frame switch + current limit in check_valid_rx_data()
+#define PROFILER_INGEST 4 // one picture byte, CRC + ingest + process_bam_input() in check_valid_rx_data()
+#define PROFILER_PROBES 5
+// HISTOGRAM - PROFILER_BINS-1 bins of 4 ticks, last bin = everything above
+// isr probes 1.6µS bins up to the shortest BAM step (19.2µS), main loop probes 12.8µS bins up to 154µS
+#define PROFILER_BIN_SHIFT 2
+#define PROFILER_BINS 13
+#define PROFILER_BIN_OVF (PROFILER_BINS-1)
+
+#ifdef PROFILER_ENABLE
+#define PROFILER_ISR_BEGIN() uint8_t profiler_t0 = profiler_begin()
+#define PROFILER_ISR_END(probe) profiler_end(probe,profiler_t0)
+#define PROFILER_MAIN_BEGIN() uint8_t profiler_t0 = profiler_begin_main()
+#define PROFILER_MAIN_END(probe) profiler_end_main(probe,profiler_t0)
+#else
+#define PROFILER_ISR_BEGIN()
+#define PROFILER_ISR_END(probe)
+#define PROFILER_MAIN_BEGIN()
+#define PROFILER_MAIN_END(probe)
+#endif
+
+// Prototypes
+#ifdef PROFILER_ENABLE
+extern void init_profiler(void);
+extern void clear_profiler(void);
+extern uint8_t profiler_begin(void);
+extern void profiler_end(uint8_t probe, uint8_t t0);
+extern uint8_t profiler_begin_main(void);
+extern void profiler_end_main(uint8_t probe, uint8_t t0);
+extern uint8_t get_profiler_min(uint8_t probe);
+extern uint8_t get_profiler_max(uint8_t probe);
+extern uint8_t get_profiler_mean(uint8_t probe);
+extern uint16_t get_profiler_bin(uint8_t probe, uint8_t bin);
+#endif
+
+#endif /* PROFILER_H_ */
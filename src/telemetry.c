@@ -0,0 +1,99 @@
+﻿/**
+ * \brief		status readback over MISO
+ * \file		telemetry.c
+ * \author 		Rene Reinsch
+ * \date		18.10.2026
+ * \version 	Rev. 3.2
+ *
+ * \details		\b readout
+ *				\n ext. LATCH = 1 & 1 x SPI RX ISR, SPI byte = EXT_OP_TELEMETRY
+ *				\n => the status block is sampled, byte 0 is written to the SPDR
+ *				\n TELEMETRY_SIZE x (SPI byte + LATCH), the host reads MISO, the sent byte is ignored
+ *				\n => every LATCH writes the next byte to the SPDR
+ *				\n 1 x LATCH => end of the command
+ *				\n a readout cut off by a new opcode or the rx timeout is dropped,
+ *				\n the next one starts with byte 0 again
+ *				\n the SPDR is written in the LATCH isr, the host has to keep the
+ *				\n LATCH pause (50µS) before the next SPI byte.
+ *				\n In a daisy-chain every tile loads its block, the host reads N bytes per LATCH
+ *				\n (the last tile first). On a multi-drop bus (MISO unconnected) there is no readout.
+ */
+
+#include <avr/io.h>
+#include "telemetry.h"
+#include "transceive_data.h"
+#include "command.h"
+#include "bam.h"
+#include "power.h"
+#include "crc.h"
+#include "thermal.h"
+#include "watchdog.h"
+
+static uint8_t telemetry_block[TELEMETRY_SIZE]; //!< sampled status, used in send_telemetry_byte()
+static volatile uint8_t telemetry_pos; //!< next byte of telemetry_block, TELEMETRY_SIZE = no readout
+
+// PROTOTYPES
+static void put_telemetry_word(uint8_t pos, uint16_t value);
+
+/** \brief Initialize the readout, no block loaded */
+void init_telemetry(void){
+	stop_telemetry();
+}
+
+/** \brief end a started readout, the next one starts with byte 0
+ *
+ * \note	called wherever the RX-Buffer is reset (transceive_data.c)
+ */
+void stop_telemetry(void){
+	telemetry_pos = TELEMETRY_SIZE;
+}
+
+/** \brief store a 16 bit value, high byte first
+ * \param  	uint8_t pos 	- TELEMETRY_x
+ * \param  	uint16_t value 	- value
+ */
+static void put_telemetry_word(uint8_t pos, uint16_t value){
+	telemetry_block[pos] = (uint8_t)(value>>8);
+	telemetry_block[pos+1] = (uint8_t)value;
+}
+
+/** \brief sample the status block and write byte 0 to the SPDR
+ *
+ * \note	called in ISR(SPI_ISR_VECTOR), needs some 10µS
+ */
+void load_telemetry(void){
+	uint8_t i;
+	uint8_t crc = CRC_8_INIT;
+	telemetry_block[TELEMETRY_TILE_ID] = get_tile_id();
+	put_telemetry_word(TELEMETRY_FRAMES,get_bam_frame_count());
+	put_telemetry_word(TELEMETRY_OVERRUNS,get_rx_overrun_count());
+	put_telemetry_word(TELEMETRY_TIMEOUTS,get_rx_timeout_count());
+	put_telemetry_word(TELEMETRY_CRC_ERRORS,get_crc_error_count());
+	put_telemetry_word(TELEMETRY_ISR_MAX,get_bam_isr_max());
+	put_telemetry_word(TELEMETRY_CYCLE_TICKS,BAM_CYCLE_TICKS);
+	telemetry_block[TELEMETRY_DUTY] = get_bam_duty();
+	put_telemetry_word(TELEMETRY_CURRENT,get_frame_current());
+	telemetry_block[TELEMETRY_TEMP] = (uint8_t)get_thermal_temp();
+	telemetry_block[TELEMETRY_THERMAL_DUTY] = get_thermal_duty();
+	telemetry_block[TELEMETRY_RESET] = get_reset_flags();
+	put_telemetry_word(TELEMETRY_STAGE_LATE,get_bam_stage_late());
+	for(i=0;i<TELEMETRY_CRC;i++){
+		crc = crc_8_update(crc,telemetry_block[i]);
+	}
+	telemetry_block[TELEMETRY_CRC] = crc;
+	clear_bam_isr_max();
+	SPI_DATA_REG = telemetry_block[0];
+	telemetry_pos = 1;
+}
+
+/** \brief write the next byte of the status block to the SPDR
+ *
+ * \note	called in ISR(PIN_CHANGE_ISR_VECTOR), nothing after the last byte
+ */
+void send_telemetry_byte(void){
+	uint8_t pos = telemetry_pos;
+	if(pos < TELEMETRY_SIZE){
+		SPI_DATA_REG = telemetry_block[pos];
+		telemetry_pos = pos + 1;
+	}
+}
@@ -0,0 +1,39 @@
+﻿/**
+ * \brief 	Telemetry Header - status readback over MISO
+ * \file	telemetry.h
+ * \author  Rene Reinsch
+ * \date		18.10.2026
+ * \version  	Rev. 3.2
+ *
+ * \details Layout of the status block
+ * 			\n Function prototypes definitions
+ */
+
+#include <avr/io.h>
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+// STATUS BLOCK - byte position, 16 bit values high byte first
+#define TELEMETRY_TILE_ID 0
+#define TELEMETRY_FRAMES 1 // switched frames, wraps
+#define TELEMETRY_OVERRUNS 3 // LATCH before the previous byte was processed
+#define TELEMETRY_TIMEOUTS 5 // frames/commands dropped by the rx timeout
+#define TELEMETRY_CRC_ERRORS 7 // frames dropped by the CRC check
+#define TELEMETRY_ISR_MAX 9 // longest BAM isr since the last readout, timer ticks (0.4µS)
+#define TELEMETRY_CYCLE_TICKS 11 // BAM cycle, timer ticks (0.4µS)
+#define TELEMETRY_DUTY 13 // BAM duty (BLANK), 0xFF = full
+#define TELEMETRY_CURRENT 14 // estimated frame current in mA
+#define TELEMETRY_TEMP 16 // °C, signed, TELEMETRY_TEMP_NONE = no sample yet
+#define TELEMETRY_THERMAL_DUTY 17 // BAM duty of the thermal derating, 0xFF = none
+#define TELEMETRY_RESET 18 // MCUSR of the last reset (WDRF, BORF, EXTRF, PORF)
+#define TELEMETRY_STAGE_LATE 19 // values the single buffer stage wrote at once, host too fast, 0 = double buffer
+#define TELEMETRY_CRC 21 // CRC-8 of byte 0-20
+#define TELEMETRY_SIZE 22
+#define TELEMETRY_TEMP_NONE 0x80
+// Prototypes
+extern void init_telemetry(void);
+extern void load_telemetry(void);
+extern void stop_telemetry(void);
+extern void send_telemetry_byte(void);
+
+#endif /* TELEMETRY_H_ */
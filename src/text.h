@@ -0,0 +1,26 @@
+﻿/**
+ * \brief 	Text Header - flash font and glyph renderer
+ * \file	text.h
+ * \author  Rene Reinsch
+ * \date		18.10.2026
+ * \version  	Rev. 3.2
+ *
+ * \details Defines for the 5x7 font
+ * 			\n Function prototypes definitions
+ */
+
+#include <avr/io.h>
+
+#ifndef TEXT_H_
+#define TEXT_H_
+// FONT - 5x7, one byte per column, bit 0 = top row
+#define TEXT_GLYPH_WIDTH 5
+#define TEXT_GLYPH_HEIGHT 7
+#define TEXT_GLYPH_SPACE 1 // empty column between two glyphs
+#define TEXT_FIRST_CHAR 0x20
+#define TEXT_LAST_CHAR 0x7E
+#define TEXT_UNKNOWN_CHAR '?'
+// Prototypes
+extern void draw_text_proc(int8_t x, int8_t y, const uint8_t *color, const uint8_t *text, uint8_t len);
+
+#endif /* TEXT_H_ */
@@ -0,0 +1,112 @@
+﻿/**
+ * \brief		board temperature and brightness derating
+ * \file		thermal.c
+ * \author 		Rene Reinsch
+ * \date		18.10.2026
+ * \version 	Rev. 3.2
+ *
+ * \details		check_thermal() starts one conversion per BAM cycle (~5mS), ISR(THERMAL_ADC_vect)
+ *				\n filters the result, the main loop never waits for the ADC.
+ *				\n Above THERMAL_DERATE_START the global BAM duty is lowered linear down to
+ *				\n THERMAL_DUTY_MIN at THERMAL_DERATE_END (set_thermal_duty), the filter keeps
+ *				\n the change smooth. Temperature and duty are part of the telemetry.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "thermal.h"
+#include "bam.h"
+#include "power.h"
+
+static volatile uint16_t thermal_acc; //!< filtered ADC value << THERMAL_FILTER_SHIFT, used in ISR(THERMAL_ADC_vect)
+static volatile uint8_t thermal_new; //!< new filtered value, used in check_thermal()
+static volatile uint8_t thermal_samples; //!< counts the first samples, the first one after the reference switch is dropped
+static uint8_t thermal_cycle; //!< BAM cycle of the last conversion, used in check_thermal()
+static int8_t thermal_temp; //!< filtered temperature in °C
+static uint8_t thermal_duty; //!< BAM duty of the derating
+
+/** \brief Initialize the ADC, no conversion started */
+void init_thermal(void){
+	ADMUX = THERMAL_ADMUX_MASK;
+	ADCSRA = THERMAL_ADCSRA_MASK;
+	thermal_acc = 0;
+	thermal_new = 0;
+	thermal_samples = 0;
+	thermal_cycle = get_bam_cycle();
+	thermal_temp = THERMAL_TEMP_NONE;
+	thermal_duty = BAM_DUTY_MAX;
+}
+
+/** \brief ISR ( ADC ) - filter the conversion
+ *  \param   	THERMAL_ADC_vect  ISR VECTOR
+ *
+ * \details	the first valid sample sets the filter, then acc += sample - acc/16
+ */
+ISR(THERMAL_ADC_vect){
+	uint16_t sample = ADC;
+	uint8_t samples = thermal_samples;
+	if(samples == 0){
+		thermal_samples = 1;
+		return;
+	}
+	if(samples == 1){
+		thermal_acc = sample << THERMAL_FILTER_SHIFT;
+		thermal_samples = 2;
+	} else {
+		thermal_acc += sample - (thermal_acc >> THERMAL_FILTER_SHIFT);
+	}
+	thermal_new = 1;
+}
+
+/** \brief start the next conversion, derate with a new temperature
+ *
+ * \details called in the main loop, one conversion per BAM cycle
+ */
+void check_thermal(void){
+	uint8_t cycle = get_bam_cycle();
+	int16_t temp;
+	uint8_t duty;
+	if(cycle != thermal_cycle && !(ADCSRA & THERMAL_ADC_START_MASK)){
+		thermal_cycle = cycle;
+		ADCSRA |= THERMAL_ADC_START_MASK;
+	}
+	if(!thermal_new){
+		return;
+	}
+	thermal_new = 0;
+	cli();
+	temp = (int16_t)(thermal_acc >> THERMAL_FILTER_SHIFT) - THERMAL_ADC_OFFSET;
+	sei();
+	if(temp < -127){
+		temp = -127;
+	} else if(temp > 127){
+		temp = 127;
+	}
+	thermal_temp = (int8_t)temp;
+	if(temp <= THERMAL_DERATE_START){
+		duty = BAM_DUTY_MAX;
+	} else if(temp >= THERMAL_DERATE_END){
+		duty = THERMAL_DUTY_MIN;
+	} else {
+		duty = BAM_DUTY_MAX - (uint8_t)(((uint16_t)(temp - THERMAL_DERATE_START) * (BAM_DUTY_MAX - THERMAL_DUTY_MIN))
+				/ (THERMAL_DERATE_END - THERMAL_DERATE_START));
+	}
+	if(duty != thermal_duty){
+		thermal_duty = duty;
+		set_thermal_duty(duty);
+	}
+}
+
+/** \brief filtered board temperature
+ * \return	°C, THERMAL_TEMP_NONE before the first sample
+ */
+int8_t get_thermal_temp(void){
+	return thermal_temp;
+}
+
+/** \brief BAM duty of the derating
+ * \return	BAM_DUTY_MAX = no derating
+ */
+uint8_t get_thermal_duty(void){
+	return thermal_duty;
+}
@@ -0,0 +1,37 @@
+﻿/**
+ * \brief 	Thermal Header - board temperature and brightness derating
+ * \file	thermal.h
+ * \author  Rene Reinsch
+ * \date		18.10.2026
+ * \version  	Rev. 3.2
+ *
+ * \details Defines for the ADC and the derating curve
+ *		  	\n -ATMEGA DATASHEET / <avr/io.h>
+ * 			\n Function prototypes definitions
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#ifndef THERMAL_H_
+#define THERMAL_H_
+// ADC - internal temperature sensor (ADC8) against the internal 1.1V reference
+#define THERMAL_ADMUX_MASK ((1<<REFS1)|(1<<REFS0)|(1<<MUX3))
+#define THERMAL_ADCSRA_MASK ((1<<ADEN)|(1<<ADIE)|(1<<ADPS2)|(1<<ADPS1)|(1<<ADPS0)) // Clock div 128 = 156kHz
+#define THERMAL_ADC_START_MASK (1<<ADSC)
+#define THERMAL_ADC_vect ADC_vect
+// SENSOR - ~1 LSB/°C, offset typ. 25°C = 314 LSB, calibrate per batch (+-10°C)
+#define THERMAL_ADC_OFFSET 289
+#define THERMAL_FILTER_SHIFT 4 // IIR filter, 16 samples (~80mS)
+#define THERMAL_TEMP_NONE (-128) // no sample yet
+// DERATING - BAM duty falls linear from BAM_DUTY_MAX at THERMAL_DERATE_START to THERMAL_DUTY_MIN at THERMAL_DERATE_END
+#define THERMAL_DERATE_START 60 // °C
+#define THERMAL_DERATE_END 80 // °C
+#define THERMAL_DUTY_MIN 0x40
+// Prototypes
+extern void init_thermal(void);
+extern void check_thermal(void);
+extern int8_t get_thermal_temp(void);
+extern uint8_t get_thermal_duty(void);
+
+#endif /* THERMAL_H_ */
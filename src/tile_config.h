@@ -0,0 +1,85 @@
+﻿/**
+ * \brief 	Tile Configuration - geometry and wiring of the board
+ * \file	tile_config.h
+ * \author  Rene Reinsch
+ * \date		18.10.2026
+ * \version  	Rev. 3.2
+ *
+ * \details Rows, columns, strings, TLC outputs per string, soft-SPI port pins
+ *			\n and the wiring formula of the LEDs. bam.h derives the BAM table size,
+ *			\n the lookup tables, the transmit kernel and RX_DATA_MAX_COUNT from it.
+ *			\n Default: rev. 3.1 board, 8*8 RGB, 6 strings of 2 TLC59281 (32 outputs).
+ *			\n The checks below stop the build of a geometry this MCU can not drive.
+ *			\n Above 85 RGB pixels the picture offsets are 16 bit (tile_offset_t),
+ *			\n e.g. 16*8: -DTILE_COLS=16 -DTILE_STRING_OUTPUTS=64, 512 Byte per BAM table
+ *			\n and splash frame, an ATmega328P (2 KB SRAM, 1 KB EEPROM).
+ */
+
+#include <avr/io.h>
+
+#ifndef TILE_CONFIG_H_
+#define TILE_CONFIG_H_
+// GEOMETRY
+#ifndef TILE_COLS
+#define TILE_COLS 8
+#endif
+#ifndef TILE_ROWS
+#define TILE_ROWS 8
+#endif
+#define TILE_CHANNELS 3 // R, G, B
+// STRINGS - every string serves one channel in one band of rows
+#define TILE_BANDS 2 // bands of rows
+#define TILE_STRINGS (TILE_CHANNELS*TILE_BANDS)
+#ifndef TILE_STRING_OUTPUTS
+#define TILE_STRING_OUTPUTS 32 // TLC outputs per string, 16 per TLC59281
+#endif
+// PINS - SCK and DATA of string n on pin n, LATCH and BLANK of all strings
+#define TILE_SCK_PORT PORTC
+#define TILE_SCK_PORT_DDR DDRC
+#define TILE_DATA_PORT PORTD
+#define TILE_DATA_PORT_DDR DDRD
+#define TILE_LAT_PORT PORTD
+#define TILE_LAT_PORT_DDR DDRD
+#define TILE_LAT_PIN 6
+#define TILE_BLANK_PORT PORTD
+#define TILE_BLANK_PORT_DDR DDRD
+#define TILE_BLANK_PIN 7
+// WIRING - string and TLC output of LED x, y, channel c (rev. 3.1 board)
+// strings: B top, B bottom, R top, R bottom, G top, G bottom
+// outputs: column by column from the middle column on, bottom to top in the band
+#define TILE_BAND_ROWS (TILE_ROWS/TILE_BANDS)
+#define TILE_CHANNEL_STRING(c) ((((c)+1)%TILE_CHANNELS)*TILE_BANDS)
+#define TILE_LED_STRING(x,y,c) (TILE_CHANNEL_STRING(c)+(y)/TILE_BAND_ROWS)
+#define TILE_LED_OUTPUT(x,y) ((((x)+TILE_COLS/2)%TILE_COLS)*TILE_BAND_ROWS+TILE_BAND_ROWS-1-(y)%TILE_BAND_ROWS)
+// OFFSET - picture offset (y*TILE_COLS+x)*TILE_CHANNELS+c, 8 bit up to 85 RGB pixels
+#if TILE_COLS*TILE_ROWS*TILE_CHANNELS > 255
+typedef uint16_t tile_offset_t;
+#else
+typedef uint8_t tile_offset_t;
+#endif
+// CHECKS
+#if TILE_COLS*TILE_ROWS > 255 || TILE_COLS > 16 || TILE_ROWS > 16
+#error "pixel counters are 8 bit, region coordinates 4 bit"
+#endif
+#if (TILE_COLS % 2) || (TILE_ROWS % 2) || (TILE_ROWS % TILE_BANDS)
+#error "YUV 4:2:0 needs even columns and rows, the bands need whole rows"
+#endif
+#if TILE_STRINGS > 6 || TILE_LAT_PIN < TILE_STRINGS || TILE_BLANK_PIN < TILE_STRINGS
+#error "the strings use pin 0..TILE_STRINGS-1 of the SCK and DATA port"
+#endif
+#if TILE_COLS*TILE_BAND_ROWS > TILE_STRING_OUTPUTS || (TILE_STRING_OUTPUTS % 16)
+#error "a string needs a TLC output per LED of its band, 16 outputs per TLC"
+#endif
+#ifdef BAM_SINGLE_BUFFER
+#define TILE_BAM_TABLES 1
+#else
+#define TILE_BAM_TABLES 2
+#endif
+#if TILE_BAM_TABLES*TILE_STRING_OUTPUTS*8 > (RAMEND+1-RAMSTART)/2
+#error "the BAM tables take more than half of the SRAM"
+#endif
+#if TILE_STRING_OUTPUTS*8 > (E2END+1)/2
+#error "the splash frame takes more than half of the EEPROM"
+#endif
+
+#endif /* TILE_CONFIG_H_ */
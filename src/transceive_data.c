@@ -11,6 +11,8 @@
  * 				\n 1. SPDR valid, vaild for RX-Counter von 0-191
  *				\n 2. enable the SPI-Interrupt
  *				\n 3. At RX_Counter=192 => saved picture data valid => switch BAM Table
+ *				\n with CRC_MODE_8 the SPI byte of this LATCH is the CRC-8 of the picture data,
+ *				\n on mismatch the frame is dropped (see crc.c)
  *				\n ext. LATCH = 1 -> 0 [Pin change from 1 to 0]
  *				\n disable the SPI-Interrupt
  *				\n\b Reset \b RX-Buffer
@@ -20,17 +22,66 @@
  *				\n LATCH = 1 & 2 x SPI RX ISR
  *				\n 1. RX-Counter=0 ( Buffer Reset )
  *				\n 2. BAM-Cycle Reset ( external Sync )
+ *				\n\b Commands
+ *				\n the SPI byte of the RX-Buffer reset is the opcode for the following data,
+ *				\n see command.c. Protocol change to Rev. 3.1: the first byte of the BAM-Cycle
+ *				\n reset is read as opcode as well. The reset itself always returns to
+ *				\n EXT_OP_FRAME, so any first byte works, but only EXT_OP_FRAME (0x00, the sync
+ *				\n byte of the old hosts) and values >= EXT_OP_COUNT have no side effect,
+ *				\n EXT_OP_TELEMETRY loads the status block into SPDR.
+ *				\n\b Multi-drop
+ *				\n several tiles may share LATCH/SCK/MOSI, EXT_OP_SELECT addresses the following
+ *				\n frames and commands (see command.c), MISO has to stay unconnected
+ *				\n\b Daisy-chain
+ *				\n tiles share LATCH/SCK, MISO of a tile feeds MOSI of the next one. The SPI
+ *				\n shift register of the slave shifts the last received byte out with the next
+ *				\n one, so a chain of N tiles is a N byte shift register without any software.
+ *				\n Per LATCH the host shifts N bytes, the byte for the last tile first, every
+ *				\n tile takes its own byte from SPDR at the LATCH. With the chain length set
+ *				\n (EXT_OP_CHAIN) the RX-Buffer reset counts N SPI bytes as one, the opcode
+ *				\n and the BAM-Cycle reset work as on a single tile
+ *				\n\b Scheduled presentation
+ *				\n the BAM-Cycle Reset also advances the frame counter of the tile. A frame after
+ *				\n EXT_OP_PRESENT_AT N is kept until the counter reaches N, all tiles of the wall
+ *				\n switch with the same BAM-Cycle Reset. The next frame may be sent after that.
+ *				\n\b Resynchronisation
+ *				\n the RX-Buffer reset is the frame start marker, a host which sends it in front
+ *				\n of every frame loses at most one frame after a missed LATCH
+ *				\n without LATCH for RX_TIMEOUT_CYCLES BAM cycles a started frame/command
+ *				\n is dropped, the next LATCH is byte 0 of a new frame
  */
 
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include <avr/eeprom.h>
 #include "transceive_data.h"
 #include "bam.h"
+#include "command.h"
+#include "ingest.h"
+#include "power.h"
+#include "crc.h"
+#include "telemetry.h"
+#include "profiler.h"
+#include "clip.h"
+#include "effect.h"
 // volatile ... used also in ISR
 static volatile uint8_t rx_buffer; //!< SPI RX-BUFFER to secure data of the SPDR, used in check_valid_rx_data() and ISR(PIN_CHANGE_ISR_VECTOR)
-static volatile uint8_t rx_byte_counter; //!< LATCH counter, used in check_valid_rx_data() and ISR(PIN_CHANGE_ISR_VECTOR)
+static volatile tile_offset_t rx_byte_counter; //!< LATCH counter, 16 bit above RX_DATA_MAX_COUNT 255, used in check_valid_rx_data() and ISR(PIN_CHANGE_ISR_VECTOR)
 static volatile uint8_t rx_flag; //!< Flag for RX data valid, used in check_valid_rx_data() and ISR(PIN_CHANGE_ISR_VECTOR)
 static volatile uint8_t ext_cmd_state_flag; //!< Flag for Reset Buffer/BAM-Cyle, used in ISR(SPI_ISR_VECTOR)
+static volatile uint8_t ext_spi_count; //!< SPI bytes of the tiles behind this one, used in ISR(SPI_ISR_VECTOR)
+static volatile uint8_t rx_chain_length; //!< tiles in the chain, used in ISR(SPI_ISR_VECTOR)
+static uint8_t rx_chain_length_ee EEMEM = RX_CHAIN_SINGLE; //!< stored chain length, used in init_SPI()
+static volatile uint8_t rx_cmd; //!< opcode of the received data, used in check_valid_rx_data() and ISR(SPI_ISR_VECTOR)
+static volatile uint8_t rx_channel; //!< color channel of the next picture byte, used in check_valid_rx_data()
+static volatile uint8_t rx_cycle; //!< BAM cycle of the last LATCH/opcode, used in check_valid_rx_data() and ISR(SPI_ISR_VECTOR)
+static volatile uint16_t rx_overrun_count; //!< LATCH before the previous byte was processed, used in ISR(PIN_CHANGE_ISR_VECTOR)
+static uint16_t rx_timeout_count; //!< dropped frames/commands after a timeout, saturates at 0xFFFF
+static uint8_t rx_present_at; //!< frame counter value of the next frame, used in check_valid_rx_data()
+static uint8_t rx_present_armed; //!< next frame is scheduled, used in check_valid_rx_data()
+static uint8_t rx_power_pending; //!< scheduled frame waits for set_frame_power(), used in check_valid_rx_data()
+static uint8_t rx_crc; //!< CRC-8 of the received picture bytes, used in check_valid_rx_data()
+static uint16_t rx_power_sum[INGEST_CHANNELS]; //!< sum of the BAM values per channel of the received frame, used in check_valid_rx_data()
 
 /** \brief Initialize the SPI */
 void init_SPI(void){
@@ -38,15 +89,31 @@ void init_SPI(void){
 	SPI_PORT |= SPI_PORT_MASK;
 	SPI_CTRL_REG = SPI_CTRL_REG_MASK;
 	SPI_DATA_REG = 0;
+	rx_cmd = EXT_OP_FRAME;
+	rx_chain_length = eeprom_read_byte(&rx_chain_length_ee);
+	if(rx_chain_length == 0 || rx_chain_length > RX_CHAIN_MAX){
+		rx_chain_length = RX_CHAIN_SINGLE;
+	}
 	reset_rx_variables();
 }
 
+/** \brief store and use a new chain length
+ * \param  	uint8_t length 	- tiles in the chain, 1 .. RX_CHAIN_MAX, RX_CHAIN_SINGLE = no chain
+ */
+void set_rx_chain_length(uint8_t length){
+	if(length && length <= RX_CHAIN_MAX){
+		rx_chain_length = length;
+		eeprom_update_byte(&rx_chain_length_ee,length);
+	}
+}
+
 /** \brief Initialize the pin change Interrupt */
 void init_PIN_CHANGE_ISR(void){
 	EXT_LAT_DDR &= ~(EXT_LAT_DDR_MASK);
 	PIN_CHANGE_EN_MASK_REG |= PIN_CHANGE_EN_MASK_REG_MASK;
 	PIN_CHANGE_ISR_EN_REG|=PIN_CHANGE_ISR_EN_REG_MASK;
 	ext_cmd_state_flag = EXT_CMD_CLR;
+	ext_spi_count = 0;
 }	
 
 /** \brief reset all variables
@@ -54,12 +121,13 @@ void init_PIN_CHANGE_ISR(void){
  * \details	clear the used administration data such as rx_buffer, clear the SPI
  */
 void reset_rx_variables(void){
-	uint8_t dum=0;
 	rx_buffer=0;
 	rx_byte_counter=0;
+	rx_channel=INGEST_CH_R;
 	rx_flag=RX_DATA_INVALID;
-	dum=SPI_STAT_REG;
-    dum=SPI_DATA_REG;
+	stop_telemetry();
+	(void)SPI_STAT_REG;
+	(void)SPI_DATA_REG;
 }	
 
 /** \brief ISR ( PIN_CHANGE ) - handle ext. LATCH
@@ -71,40 +139,171 @@ void reset_rx_variables(void){
  *			\n 3. At RX_Counter=192 => saved picture data valid => switch BAM Table
  *			\n ext. LATCH = 1 -> 0 [Pin change from 1 to 0]
  *			\n disable the SPI-Interrupt
+ *			\n a LATCH before check_valid_rx_data() took the previous byte is an overrun
+ *			\n during EXT_OP_TELEMETRY the next status byte is written to the SPDR
  *
- * \note	uint8_t dum = SPI_STAT_REG; clears the ISR flag!!!!
+ * \note	(void)SPI_STAT_REG; clears the ISR flag!!!!
  */
 ISR(PIN_CHANGE_ISR_VECTOR){	
+	PROFILER_ISR_BEGIN();
 	if (EXT_LAT_PIN_REG & EXT_LAT_PIN_MASK){
-        uint8_t dum = SPI_STAT_REG;
+        (void)SPI_STAT_REG;
 		rx_buffer=SPI_DATA_REG;		
+		if(rx_flag == RX_DATA_VALID && rx_overrun_count < 0xFFFF){
+			rx_overrun_count++;
+		}
 		rx_flag = RX_DATA_VALID;
+		if(rx_cmd == EXT_OP_TELEMETRY){
+			send_telemetry_byte();
+		}
 		SPI_CTRL_REG |= (SPI_ENABLE_ISR_MASK);
 	} else {
 		SPI_CTRL_REG &= SPI_DISABLE_ISR_MASK;
 		ext_cmd_state_flag = EXT_CMD_CLR;
+		ext_spi_count = 0;
 	}
+	PROFILER_ISR_END(PROFILER_LATCH_ISR);
 }
 
 /** \brief handle valid rx-data
  *
  * \details In case from rx_byte_counter from 0 to 191 save rx_buffer byte
- * 			to BAM buffer(calc_tbl_mem) ... uses the process_bam_input function
+ * 			to BAM buffer(calc_tbl_mem) ... uses the ingest_byte and process_bam_input function
  * 		  	In case rx_byte_counter >= 192 ->switch the source pointer of the BAM
+ *			\n and limit the current of the new frame (set_frame_power)
+ *			\n with CRC_MODE_8 only if rx_buffer matches the CRC of the picture bytes
+ *			\n EXT_OP_FRAME_YUV is the same with 96 byte, ingest_yuv() gives a pixel per Y byte
+ *			\n Command payload is stored by process_cmd_input, the following LATCH executes it
+ *			\n Frames while the tile is not selected (EXT_OP_SELECT) are counted but not stored
+ *			\n A scheduled frame (EXT_OP_PRESENT_AT) is switched by ISR(SPI_ISR_VECTOR),
+ *			\n the current limit follows here
+ *			\n A started frame/command without LATCH for RX_TIMEOUT_CYCLES is dropped
  */
 void check_valid_rx_data(void){
 	if(rx_flag == RX_DATA_VALID){
-		if(rx_byte_counter<RX_DATA_MAX_COUNT){
-			process_bam_input(rx_buffer,rx_byte_counter);
-			rx_byte_counter++;			
+		if(rx_cmd == EXT_OP_FRAME || rx_cmd == EXT_OP_FRAME_YUV){
+			if(rx_byte_counter<get_cmd_size(rx_cmd)){
+				// frames for other tiles are only counted
+				if(get_cmd_selected()){
+					if(rx_byte_counter==0){
+						stop_bam_fade();
+						stop_clip();
+						stop_effect();
+						rx_power_sum[INGEST_CH_R]=0;
+						rx_power_sum[INGEST_CH_G]=0;
+						rx_power_sum[INGEST_CH_B]=0;
+						rx_crc=CRC_8_INIT;
+						rx_power_pending=0;
+					}
+					PROFILER_MAIN_BEGIN();
+					rx_crc=crc_8_update(rx_crc,rx_buffer);
+					if(rx_cmd == EXT_OP_FRAME){
+						uint8_t channel = rx_channel;
+						uint8_t value = ingest_byte(rx_buffer,channel);
+						process_bam_input(value,rx_byte_counter);
+						rx_power_sum[channel]+=value;
+						channel++;
+						if(channel>=INGEST_CHANNELS){
+							channel=INGEST_CH_R;
+						}
+						rx_channel=channel;
+					} else {
+						uint8_t rgb[INGEST_CHANNELS];
+						tile_offset_t offset = ingest_yuv(rx_buffer,rx_byte_counter,rgb);
+						if(offset != INGEST_YUV_NONE){
+							uint8_t c;
+							for(c=0;c<INGEST_CHANNELS;c++){
+								process_bam_input(rgb[c],offset+c);
+								rx_power_sum[c]+=rgb[c];
+							}
+						}
+					}
+					PROFILER_MAIN_END(PROFILER_INGEST);
+				}
+				rx_byte_counter++;
+			} else {
+				if(get_cmd_selected()){
+					PROFILER_MAIN_BEGIN();
+					if(get_crc_mode() != CRC_MODE_OFF && rx_buffer != rx_crc){
+						count_crc_error();
+					} else if(!rx_present_armed){
+						switch_bam_pointer();
+						set_frame_power(rx_power_sum);
+					} else if(schedule_bam_pointer(rx_present_at)){
+						set_frame_power(rx_power_sum);
+					} else {
+						rx_power_pending=1;
+					}
+					rx_present_armed=0;
+					PROFILER_MAIN_END(PROFILER_COMMIT);
+				}
+				rx_byte_counter=0;
+				rx_channel=INGEST_CH_R;
+				stop_telemetry();
+			}
 		} else {
-			switch_bam_pointer();
-			rx_byte_counter=0;
-		}	
+			if(rx_byte_counter<get_cmd_size(rx_cmd)){
+				process_cmd_input(rx_buffer,rx_byte_counter);
+				rx_byte_counter++;
+			} else {
+				execute_cmd(rx_cmd);
+				rx_cmd=EXT_OP_FRAME;
+				rx_byte_counter=0;
+				stop_telemetry();
+			}
+		}
+		rx_cycle=get_bam_cycle();
 		rx_flag=RX_DATA_INVALID;
+	} else if(rx_byte_counter || rx_cmd != EXT_OP_FRAME){
+		// no LATCH/opcode may slip in between check and reset
+		cli();
+		if(rx_flag == RX_DATA_INVALID && (uint8_t)(get_bam_cycle()-rx_cycle) > RX_TIMEOUT_CYCLES){
+			rx_cmd=EXT_OP_FRAME;
+			rx_byte_counter=0;
+			rx_channel=INGEST_CH_R;
+			stop_telemetry();
+			if(rx_timeout_count < 0xFFFF){
+				rx_timeout_count++;
+			}
+		}
+		sei();
+	}
+	// the isr which switched the scheduled frame woke the main loop
+	if(rx_power_pending && take_bam_present()){
+		rx_power_pending=0;
+		set_frame_power(rx_power_sum);
 	}
 }
 
+/** \brief schedule the next received frame
+ * \param  	uint8_t count 	- frame counter value, see schedule_bam_pointer()
+ */
+void set_rx_present_at(uint8_t count){
+	rx_present_at=count;
+	rx_present_armed=1;
+}
+
+/** \brief picture/command byte waiting for check_valid_rx_data()
+ * \return	1 = LATCH not yet handled, the main loop must not sleep
+ */
+uint8_t get_rx_pending(void){
+	return rx_flag == RX_DATA_VALID;
+}
+
+/** \brief number of overruns
+ * \return	LATCHes before the previous byte was processed since reset
+ */
+uint16_t get_rx_overrun_count(void){
+	return rx_overrun_count;
+}
+
+/** \brief number of timeouts
+ * \return	frames/commands dropped by the rx timeout since reset
+ */
+uint16_t get_rx_timeout_count(void){
+	return rx_timeout_count;
+}
+
 /** \brief ISR ( SPI ) - handle Reset Buffer / Reset BAM cyle
  *  \param   SPI_ISR_VECTOR ISR VECTOR
  *
@@ -115,14 +314,40 @@ void check_valid_rx_data(void){
  *			\n LATCH = 1 & 2 x SPI RX ISR
  *			\n 1. RX-Counter=0 ( Buffer Reset )
  *			\n 2. **BAM-Cycle Reset** ( external Sync )
+ *			\n the first SPI byte selects the opcode of the following data,
+ *			\n unknown opcodes select EXT_OP_FRAME without side effects, the BAM-Cycle
+ *			\n Reset drops the opcode of its first byte, the frame follows
+ *			\n the timeout of check_valid_rx_data() restarts with the opcode
+ *			\n in a chain only every rx_chain_length-th byte counts, it is the own one
+ *			\n the BAM-Cycle Reset advances the frame counter (advance_bam_present)
  *
  * \note	not used for any BAM picture data
  */
 ISR(SPI_ISR_VECTOR){
+	PROFILER_ISR_BEGIN();
+	uint8_t ext_op = SPI_DATA_REG;
+	uint8_t spi_count = ext_spi_count + 1;
+	if(spi_count < rx_chain_length){
+		ext_spi_count = spi_count;
+		PROFILER_ISR_END(PROFILER_SPI_ISR);
+		return;
+	}
+	ext_spi_count = 0;
 	reset_rx_variables();
 	if(ext_cmd_state_flag == EXT_CMD_CLR_RX_BUFFER){
 		reset_BAM();
+		advance_bam_present();
 		start_timer();
+		rx_cmd = EXT_OP_FRAME;
+	} else if(ext_op < EXT_OP_COUNT){
+		rx_cmd = ext_op;
+		if(ext_op == EXT_OP_TELEMETRY && get_cmd_selected()){
+			load_telemetry();
+		}
+	} else {
+		rx_cmd = EXT_OP_FRAME;
 	}
+	rx_cycle = get_bam_cycle();
 	ext_cmd_state_flag = EXT_CMD_CLR_RX_BUFFER;
+	PROFILER_ISR_END(PROFILER_SPI_ISR);
 }
@@ -6,12 +6,13 @@
  * \version  	Rev. 3.1 22.2.2014
  *
  * \details Defines for administration
- *		  	\n -ATMEGA DATASHEET / <avr/*.h>
+ *		  	\n -ATMEGA DATASHEET / <avr/io.h>
  * 			\n Function prototypes definitions
  */
 
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include "tile_config.h"
 
 #ifndef TRANSCEIVE_DATA_H_
 #define TRANSCEIVE_DATA_H_
@@ -42,16 +43,25 @@
 // SPI RX-ADMINISTRATION
 #define RX_DATA_VALID 0x01
 #define RX_DATA_INVALID 0x00
-#define RX_DATA_MAX_COUNT 192 
+#define RX_DATA_MAX_COUNT (TILE_COLS*TILE_ROWS*TILE_CHANNELS) // 192 on the 8*8 tile
+#define RX_TIMEOUT_CYCLES 4 // BAM cycles (~5mS) without LATCH before a started frame/command is dropped
 // EXT_LATCH-ADMINISTRATION
 #define EXT_CMD_CLR_RX_BUFFER 0x02
 #define EXT_CMD_RESET_BAM 0x04
 #define EXT_CMD_SET 0x01
 #define EXT_CMD_CLR 0x00
+// DAISY-CHAIN - tiles per chain, erased EEPROM = RX_CHAIN_SINGLE
+#define RX_CHAIN_SINGLE 1
+#define RX_CHAIN_MAX 64
 // Prototypes
 extern void init_SPI(void);
 extern void init_PIN_CHANGE_ISR(void);
 extern void check_valid_rx_data(void);
 extern void reset_rx_variables(void);
+extern void set_rx_chain_length(uint8_t length);
+extern void set_rx_present_at(uint8_t count);
+extern uint8_t get_rx_pending(void);
+extern uint16_t get_rx_overrun_count(void);
+extern uint16_t get_rx_timeout_count(void);
 
 #endif /* TRANSCEIVE_DATA_H_ */
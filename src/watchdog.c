@@ -0,0 +1,45 @@
+﻿/**
+ * \brief		watchdog and reset cause
+ * \file		watchdog.c
+ * \author 		Rene Reinsch
+ * \date		18.10.2026
+ * \version 	Rev. 3.2
+ *
+ * \details		the reset cause (MCUSR) is taken in .init3, before the startup code clears
+ *				\n the SRAM. After a watchdog reset the watchdog stays on with the shortest
+ *				\n timeout, so it is switched off there too. init_BAM() keeps the shown frame
+ *				\n after a watchdog reset (see bam.c).
+ *				\n The main loop resets the watchdog, a hanging main loop or a stopped BAM
+ *				\n timer (no wake up) restarts the tile.
+ */
+
+#include <avr/io.h>
+#include <avr/wdt.h>
+#include "watchdog.h"
+
+static uint8_t watchdog_reset_flags __attribute__((section(".noinit"))); //!< MCUSR of the last reset
+
+// PROTOTYPES
+void capture_reset_flags(void) __attribute__((naked, used, section(".init3")));
+
+/** \brief take and clear MCUSR, switch off the watchdog
+ *
+ * \note	runs in .init3, no stack frame, no return
+ */
+void capture_reset_flags(void){
+	watchdog_reset_flags = MCUSR;
+	MCUSR = 0;
+	wdt_disable();
+}
+
+/** \brief start the watchdog */
+void init_watchdog(void){
+	wdt_enable(WATCHDOG_TIMEOUT);
+}
+
+/** \brief cause of the last reset
+ * \return	MCUSR bits (WDRF, BORF, EXTRF, PORF)
+ */
+uint8_t get_reset_flags(void){
+	return watchdog_reset_flags;
+}
@@ -0,0 +1,25 @@
+﻿/**
+ * \brief 	Watchdog Header - watchdog and reset cause
+ * \file	watchdog.h
+ * \author  Rene Reinsch
+ * \date		18.10.2026
+ * \version  	Rev. 3.2
+ *
+ * \details Defines for the watchdog
+ * 			\n Function prototypes definitions
+ */
+
+#include <avr/io.h>
+#include <avr/wdt.h>
+
+#ifndef WATCHDOG_H_
+#define WATCHDOG_H_
+// WATCHDOG - the main loop runs at least every BAM step (2.6mS), EEPROM writes need ~3.3mS per byte
+#define WATCHDOG_TIMEOUT WDTO_250MS
+// RESET CAUSE - MCUSR bits
+#define WATCHDOG_RESET_MASK (1<<WDRF)
+// Prototypes
+extern void init_watchdog(void);
+extern uint8_t get_reset_flags(void);
+
+#endif /* WATCHDOG_H_ */
@@ -0,0 +1,22 @@
+/**
+ * \brief 	Host replay - EEPROM variables in RAM
+ * \file	avr/eeprom.h
+ *
+ * \details EEMEM variables are plain variables, the replay starts with
+ *			\n their initial values like a freshly programmed tile
+ */
+
+#ifndef REPLAY_AVR_EEPROM_H_
+#define REPLAY_AVR_EEPROM_H_
+#include <stdint.h>
+#include <string.h>
+#define EEMEM
+#define eeprom_is_ready() 1
+#define eeprom_read_byte(p) (*(const uint8_t *)(p))
+#define eeprom_read_word(p) (*(const uint16_t *)(p))
+#define eeprom_read_block(dst,src,n) memcpy((dst),(src),(n))
+#define eeprom_update_byte(p,v) (*(uint8_t *)(p) = (v))
+#define eeprom_update_word(p,v) (*(uint16_t *)(p) = (v))
+#define eeprom_update_block(src,dst,n) memcpy((dst),(src),(n))
+
+#endif /* REPLAY_AVR_EEPROM_H_ */
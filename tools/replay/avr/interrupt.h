@@ -0,0 +1,25 @@
+/**
+ * \brief 	Host replay - interrupts as plain functions
+ * \file	avr/interrupt.h
+ *
+ * \details replay.c calls the ISRs one after the other, nothing interrupts
+ *			\n the firmware, cli()/sei() have nothing to do
+ */
+
+#ifndef REPLAY_AVR_INTERRUPT_H_
+#define REPLAY_AVR_INTERRUPT_H_
+#define ISR(vector) void vector(void)
+#define cli() do{}while(0)
+#define sei() do{}while(0)
+// VECTORS
+#define TIMER1_OVF_vect replay_isr_timer1_ovf
+#define TIMER1_COMPA_vect replay_isr_timer1_compa
+#define TIMER0_OVF_vect replay_isr_timer0_ovf
+#define SPI_STC_vect replay_isr_spi
+#define PCINT0_vect replay_isr_pcint0
+#define ADC_vect replay_isr_adc
+extern void replay_isr_timer1_ovf(void);
+extern void replay_isr_spi(void);
+extern void replay_isr_pcint0(void);
+
+#endif /* REPLAY_AVR_INTERRUPT_H_ */
@@ -0,0 +1,91 @@
+/**
+ * \brief 	Host replay - ATmega88 registers as plain variables
+ * \file	avr/io.h
+ *
+ * \details only the registers and bits the firmware uses, defined in replay.c.
+ *			\n REPLAY_REGS(R) expands R(name) per 8 bit register.
+ */
+
+#ifndef REPLAY_AVR_IO_H_
+#define REPLAY_AVR_IO_H_
+#include <stdint.h>
+// REGISTERS
+#define REPLAY_REGS(R) \
+	R(PORTB) R(PORTC) R(PORTD) R(DDRB) R(DDRC) R(DDRD) R(PINB) R(PINC) R(PIND) \
+	R(SPCR) R(SPSR) R(SPDR) R(PCMSK0) R(PCICR) R(PCIFR) \
+	R(TCCR1A) R(TCCR1B) R(TCCR1C) R(TIMSK1) R(TIFR1) R(TCNT1L) R(TCNT1H) R(OCR1AL) R(OCR1AH) \
+	R(TCCR0A) R(TCCR0B) R(TCNT0) R(TIMSK0) R(TIFR0) \
+	R(MCUSR) R(WDTCSR) R(SMCR) R(ADMUX) R(ADCSRA) R(ADCSRB) R(ADCL) R(ADCH) R(DIDR0) R(PRR) R(EECR) R(SREG)
+#define REPLAY_REG_EXTERN(n) extern volatile uint8_t n;
+REPLAY_REGS(REPLAY_REG_EXTERN)
+// 16 bit registers, read only by the firmware (the timer is counted in replay.c)
+#define TCNT1 ((uint16_t)(((uint16_t)TCNT1H<<8) | TCNT1L)) // the reload written by the firmware
+extern volatile uint16_t OCR1A;
+extern volatile uint16_t ADC;
+extern volatile uint16_t ADCW;
+// BITS
+#define DDB0 0
+#define DDB1 1
+#define DDB2 2
+#define DDB3 3
+#define DDB4 4
+#define DDB5 5
+#define PB0 0
+#define PB1 1
+#define PB4 4
+#define PORTB0 0
+#define PORTB1 1
+#define PINB1 1
+#define SPE 6
+#define SPIE 7
+#define MSTR 4
+#define SPIF 7
+#define WCOL 6
+#define PCINT1 1
+#define PCIE0 0
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define CS00 0
+#define CS01 1
+#define CS02 2
+#define TOIE1 0
+#define OCIE1A 1
+#define TOV1 0
+#define OCF1A 1
+#define TOV0 0
+#define WDRF 3
+#define BORF 2
+#define EXTRF 1
+#define PORF 0
+#define REFS0 6
+#define REFS1 7
+#define ADLAR 5
+#define MUX0 0
+#define MUX3 3
+#define ADEN 7
+#define ADSC 6
+#define ADATE 5
+#define ADIF 4
+#define ADIE 3
+#define ADPS0 0
+#define ADPS1 1
+#define ADPS2 2
+#define PRTWI 7
+#define PRTIM2 6
+#define PRTIM0 5
+#define PRTIM1 3
+#define PRSPI 2
+#define PRUSART0 1
+#define PRADC 0
+// MEMORY - ATmega88, -DREPLAY_ATMEGA328P for the 2 KB SRAM / 1 KB EEPROM part (16*8 tiles)
+#define RAMSTART 0x100
+#ifdef REPLAY_ATMEGA328P
+#define RAMEND 0x8FF
+#define E2END 0x3FF
+#else
+#define RAMEND 0x4FF
+#define E2END 0x1FF
+#endif
+
+#endif /* REPLAY_AVR_IO_H_ */
@@ -0,0 +1,16 @@
+/**
+ * \brief 	Host replay - flash data in RAM
+ * \file	avr/pgmspace.h
+ */
+
+#ifndef REPLAY_AVR_PGMSPACE_H_
+#define REPLAY_AVR_PGMSPACE_H_
+#include <stdint.h>
+#include <string.h>
+#define PROGMEM
+#define PGM_P const char *
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(p))
+#define memcpy_P memcpy
+
+#endif /* REPLAY_AVR_PGMSPACE_H_ */
@@ -0,0 +1,18 @@
+/**
+ * \brief 	Host replay - no watchdog
+ * \file	avr/wdt.h
+ */
+
+#ifndef REPLAY_AVR_WDT_H_
+#define REPLAY_AVR_WDT_H_
+#define WDTO_15MS 0
+#define WDTO_30MS 1
+#define WDTO_60MS 2
+#define WDTO_120MS 3
+#define WDTO_250MS 4
+#define WDTO_500MS 5
+#define wdt_enable(timeout) do{}while(0)
+#define wdt_disable() do{}while(0)
+#define wdt_reset() do{}while(0)
+
+#endif /* REPLAY_AVR_WDT_H_ */
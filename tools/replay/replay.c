@@ -0,0 +1,430 @@
+/**
+ * \brief		Trace replay - host build of the tile firmware
+ * \file		replay.c
+ * \author  	Rene Reinsch
+ * \date		18.10.2026
+ * \version  	Rev. 3.2
+ *
+ * \details		Replays a recorded LATCH/SPI trace through the unchanged firmware sources
+ *				\n (transceive_data.c, command.c, bam.c, ...) ISR by ISR in simulated time.
+ *				\n Every switched frame is read back from the shown BAM table with
+ *				\n read_bam_input() (the inverse of the lookup tables) and written as PPM,
+ *				\n the canonical picture or with -t the tile as mounted (get_bam_orient()),
+ *				\n at the end the throughput and the dropped bytes are reported.
+ *				\n\b Trace - text, one event per line, '#' starts a comment
+ *				\n <time µS> L <hex>	LATCH 0 -> 1, the SPDR holds <hex>
+ *				\n <time µS> S <hex>	SPI byte complete, an ISR only while LATCH = 1
+ *				\n <time µS> F		LATCH 1 -> 0
+ *				\n\b Capture
+ *				\n wol_replay -c <csv> converts the transitions of a logic analyzer on the
+ *				\n tile input into the trace (SPI mode 0, msb first), one line per transition:
+ *				\n <time S>,<LATCH>,<SCK>,<MOSI>, lines without a number in front are skipped
+ *				\n\b Timing
+ *				\n ISR(TIMER_16_vect) follows the reload values of the firmware (0.4µS ticks).
+ *				\n The main loop needs -m µS per LATCH byte, a LATCH within that time is an
+ *				\n overrun as on the tile. Thermal, watchdog and BLANK are not simulated.
+ *				\n An ISR takes no simulated time, TCNT1 reads the reload of the firmware, so
+ *				\n get_bam_isr_max() (TELEMETRY_ISR_MAX) stays 0, it is no measurement.
+ *				\n make DEFS=-DBAM_SINGLE_BUFFER replays the single buffer stage, a frame
+ *				\n is rendered at its switch with the staged values (read_bam_input()).
+ *				\n\b Test
+ *				\n make check replays test/<name>.trace with -t and compares every PPM
+ *				\n frame with test/<name>/ (frames, orientation, text).
+ *				\n\b Usage
+ *				\n wol_replay [-r rate] [-m main µS] [-o dir] [-s scale] [-t] [-n] <trace>
+ *				\n wol_replay -c <csv> > <trace>
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bam.h"
+#include "transceive_data.h"
+#include "command.h"
+#include "ingest.h"
+#include "power.h"
+#include "crc.h"
+#include "telemetry.h"
+#include "clip.h"
+#include "effect.h"
+
+// REPLAY
+#define REPLAY_TICK_US (8.0*1000000.0/F_CPU) // timer16 clk/8
+#define REPLAY_TIMER_SIZE 0x10000
+#define REPLAY_MAIN_US 20.0 // main loop per LATCH byte, process_bam_input() and ingest
+#define REPLAY_NEVER 1e300
+#define REPLAY_LINE_SIZE 256
+#define REPLAY_PATH_SIZE 512
+// TRACE EVENTS
+#define REPLAY_EV_LATCH_SET 'L'
+#define REPLAY_EV_SPI 'S'
+#define REPLAY_EV_LATCH_CLR 'F'
+#define REPLAY_EV_END 0
+
+// REGISTERS - read and written by the firmware
+#define REPLAY_REG_DEFINE(n) volatile uint8_t n;
+REPLAY_REGS(REPLAY_REG_DEFINE)
+volatile uint16_t OCR1A;
+volatile uint16_t ADC;
+volatile uint16_t ADCW;
+
+// SIMULATION
+static double replay_time; //!< simulated µS since start
+static double replay_rate = 1.0; //!< trace time / replay time
+static double replay_main_us = REPLAY_MAIN_US; //!< main loop time per LATCH byte
+static double replay_bam_next = REPLAY_NEVER; //!< next ISR(TIMER_16_vect)
+static double replay_main_done = REPLAY_NEVER; //!< end of the running main loop pass
+static double replay_main_free; //!< main loop idle from here on
+static uint8_t replay_main_wake; //!< an ISR woke the main loop
+
+// STATISTICS
+static unsigned long replay_events; //!< trace lines
+static unsigned long replay_latches; //!< LATCH 0 -> 1
+static unsigned long replay_frames; //!< switched frames
+static uint16_t replay_frame_count; //!< last get_bam_frame_count()
+
+// OUTPUT
+static const char *replay_dir = "."; //!< PPM directory
+static int replay_scale = 1; //!< PPM pixels per LED
+static uint8_t replay_render = 1; //!< write the PPM frames
+static uint8_t replay_mounted; //!< PPM of the tile as mounted, orientation applied
+
+/** \brief take a timer reload written by the firmware
+ *
+ * \details	the firmware writes TCNT1H/TCNT1L for every reload (init_BAM(),
+ *			\n ISR(TIMER_16_vect), reset_BAM()), none of its reload values is 0
+ */
+static void sync_timer(void){
+	uint16_t reload = ((uint16_t)TCNT1H<<8) | TCNT1L;
+	if(!TCCR1B){
+		replay_bam_next = REPLAY_NEVER;
+	} else if(reload){
+		replay_bam_next = replay_time + (REPLAY_TIMER_SIZE - reload)*REPLAY_TICK_US;
+	}
+	TCNT1H = 0;
+	TCNT1L = 0;
+}
+
+/** \brief write the shown frame as PPM
+ *
+ * \details	read_bam_input() per LED, the BAM values after ingest and orientation
+ *			\n mounted: LED x, y shows the canonical pixel of the inverse orientation,
+ *			\n mirror first, then transpose (see orient_bam_offset())
+ */
+static void render_frame(void){
+	char path[REPLAY_PATH_SIZE];
+	FILE *file;
+	uint8_t orient = replay_mounted ? get_bam_orient() : BAM_ORIENT_NONE;
+	int x, y, c, i, px, py, t;
+	if(!replay_render){
+		return;
+	}
+	snprintf(path,sizeof(path),"%s/frame_%05lu.ppm",replay_dir,replay_frames);
+	file = fopen(path,"wb");
+	if(!file){
+		perror(path);
+		exit(EXIT_FAILURE);
+	}
+	fprintf(file,"P6\n%d %d\n255\n",BAM_COLS*replay_scale,BAM_ROWS*replay_scale);
+	for(y=0;y<BAM_ROWS*replay_scale;y++){
+		for(x=0;x<BAM_COLS*replay_scale;x++){
+			px = x/replay_scale;
+			py = y/replay_scale;
+			if(orient & BAM_ORIENT_MIRROR_X){
+				px = BAM_COLS-1-px;
+			}
+			if(orient & BAM_ORIENT_MIRROR_Y){
+				py = BAM_ROWS-1-py;
+			}
+			if(orient & BAM_ORIENT_TRANSPOSE){
+				t = px;
+				px = py;
+				py = t;
+			}
+			i = (py*BAM_COLS + px)*BAM_CHANNELS;
+			for(c=0;c<BAM_CHANNELS;c++){
+				fputc(read_bam_input(i+c),file);
+			}
+		}
+	}
+	fclose(file);
+}
+
+/** \brief count and render the frames switched by the last firmware call */
+static void check_frame(void){
+	uint16_t count = get_bam_frame_count();
+	if(count != replay_frame_count){
+		replay_frame_count = count;
+		render_frame();
+		replay_frames++;
+	}
+}
+
+/** \brief run an ISR of the firmware
+ * \param  	void (*isr)(void) 	- replay_isr_x
+ */
+static void call_isr(void (*isr)(void)){
+	isr();
+	sync_timer();
+	check_frame();
+	replay_main_wake = 1;
+}
+
+/** \brief one pass of the main loop of main.c, without thermal and watchdog */
+static void run_main_loop(void){
+	check_valid_rx_data();
+	check_bam_splash();
+	check_clip();
+	check_effect();
+#ifdef BAM_SINGLE_BUFFER
+	check_bam_stage();
+#endif
+	sync_timer();
+	check_frame();
+}
+
+/** \brief same as main.c up to the main loop */
+static void init_tile(void){
+	uint16_t sum[INGEST_CHANNELS];
+	init_SPI();
+	init_PIN_CHANGE_ISR();
+	init_BAM(0);
+	init_ingest();
+	init_power();
+	init_crc();
+	init_cmd();
+	init_telemetry();
+	sum_bam_mem(sum);
+	set_frame_power(sum);
+	start_timer();
+	sync_timer();
+	replay_frame_count = get_bam_frame_count();
+}
+
+/** \brief apply a trace event to the tile inputs
+ * \param  	char type 		- REPLAY_EV_x
+ * \param  	uint8_t data 	- SPI byte
+ */
+static void apply_event(char type, uint8_t data){
+	switch(type){
+		case REPLAY_EV_LATCH_SET:
+			SPDR = data;
+			PINB |= EXT_LAT_PIN_MASK;
+			replay_latches++;
+			call_isr(replay_isr_pcint0);
+			break;
+		case REPLAY_EV_SPI:
+			SPDR = data;
+			if(SPCR & (1<<SPIE)){
+				call_isr(replay_isr_spi);
+			}
+			break;
+		case REPLAY_EV_LATCH_CLR:
+			PINB &= ~EXT_LAT_PIN_MASK;
+			call_isr(replay_isr_pcint0);
+			break;
+	}
+}
+
+/** \brief read the next event of the trace
+ * \param  	FILE *trace 	- trace file
+ * \param  	double *time 	- replay time of the event
+ * \param  	uint8_t *data 	- SPI byte
+ * \return	REPLAY_EV_x, REPLAY_EV_END at the end of the file
+ */
+static char read_event(FILE *trace, double *time, uint8_t *data){
+	char line[REPLAY_LINE_SIZE];
+	char type;
+	unsigned int value;
+	int fields;
+	while(fgets(line,sizeof(line),trace)){
+		if(line[0] == '#' || line[0] == '\n' || line[0] == '\r'){
+			continue;
+		}
+		value = 0;
+		fields = sscanf(line,"%lf %c %x",time,&type,&value);
+		if(fields < 2 || (type != REPLAY_EV_LATCH_CLR && fields < 3)
+			|| (type != REPLAY_EV_LATCH_SET && type != REPLAY_EV_SPI && type != REPLAY_EV_LATCH_CLR)){
+			fprintf(stderr,"bad trace line: %s",line);
+			exit(EXIT_FAILURE);
+		}
+		*time /= replay_rate;
+		*data = (uint8_t)value;
+		replay_events++;
+		return type;
+	}
+	return REPLAY_EV_END;
+}
+
+/** \brief replay a trace
+ * \param  	FILE *trace 	- trace file
+ *
+ * \details	the next of trace event, ISR(TIMER_16_vect) and end of the main loop pass
+ *			\n runs first. A woken main loop starts at once when idle, a pass with a
+ *			\n LATCH byte ends replay_main_us later, the firmware runs at its end.
+ */
+static void replay_trace(FILE *trace){
+	double event_time = 0;
+	uint8_t event_data = 0;
+	char event = read_event(trace,&event_time,&event_data);
+	while(event != REPLAY_EV_END || replay_main_wake || replay_main_done < REPLAY_NEVER){
+		double next_event = (event != REPLAY_EV_END) ? event_time : REPLAY_NEVER;
+		if(replay_main_wake && replay_main_done == REPLAY_NEVER){
+			double start = (replay_time > replay_main_free) ? replay_time : replay_main_free;
+			replay_main_done = start + (get_rx_pending() ? replay_main_us : 0);
+			replay_main_wake = 0;
+		}
+		if(replay_bam_next <= next_event && replay_bam_next <= replay_main_done){
+			replay_time = replay_bam_next;
+			call_isr(replay_isr_timer1_ovf);
+		} else if(replay_main_done <= next_event){
+			replay_time = replay_main_done;
+			replay_main_free = replay_main_done;
+			replay_main_done = REPLAY_NEVER;
+			run_main_loop();
+			// a byte came in meanwhile, the main loop does not sleep
+			if(get_rx_pending()){
+				replay_main_wake = 1;
+			}
+		} else {
+			if(event_time > replay_time){
+				replay_time = event_time;
+			}
+			apply_event(event,event_data);
+			event = read_event(trace,&event_time,&event_data);
+		}
+	}
+}
+
+/** \brief convert logic analyzer transitions into a trace
+ * \param  	FILE *csv 	- <time S>,<LATCH>,<SCK>,<MOSI> per line
+ *
+ * \details	SPI mode 0, msb first: MOSI is taken with the rising SCK, every 8th bit
+ *			\n completes a byte (SPI slave without SS). The byte before LATCH 0 -> 1 is the
+ *			\n SPDR of the LATCH, bytes while LATCH = 1 are the opcode/reset bytes.
+ */
+static void convert_capture(FILE *csv){
+	char line[REPLAY_LINE_SIZE];
+	double time;
+	int latch, sck, mosi;
+	int last_latch = 0, last_sck = 0;
+	uint8_t shift = 0, spdr = 0;
+	uint8_t bits = 0;
+	printf("# wol trace, time µS, L <spdr> / S <byte> / F\n");
+	while(fgets(line,sizeof(line),csv)){
+		if(sscanf(line,"%lf , %d , %d , %d",&time,&latch,&sck,&mosi) != 4){
+			continue;
+		}
+		time *= 1000000.0;
+		if(latch && !last_latch){
+			printf("%.3f L %02X\n",time,spdr);
+		} else if(!latch && last_latch){
+			printf("%.3f F\n",time);
+		}
+		if(sck && !last_sck){
+			shift = (uint8_t)((shift<<1) | (mosi ? 1 : 0));
+			bits++;
+			if(bits == 8){
+				bits = 0;
+				spdr = shift;
+				printf("%.3f S %02X\n",time,spdr);
+			}
+		}
+		last_latch = latch;
+		last_sck = sck;
+	}
+}
+
+/** \brief print the summary of the replay
+ * \param  	double host_ms 	- host run time
+ */
+static void print_report(double host_ms){
+	double trace_s = replay_time*replay_rate/1000000.0;
+	double replay_s = replay_time/1000000.0;
+	printf("trace:      %lu events, %lu LATCH, %.1f mS (%.1f mS at rate %.2f)\n",
+		replay_events,replay_latches,trace_s*1000.0,replay_s*1000.0,replay_rate);
+	if(replay_s > 0){
+		printf("throughput: %.0f bytes/S, %.1f frames/S\n",replay_latches/replay_s,replay_frames/replay_s);
+	}
+	printf("frames:     %lu switched\n",replay_frames);
+	printf("dropped:    %u overrun, %u timeout, %u CRC error\n",
+		get_rx_overrun_count(),get_rx_timeout_count(),get_crc_error_count());
+#ifdef BAM_SINGLE_BUFFER
+	printf("stage:      %u late (single buffer)\n",get_bam_stage_late());
+#endif
+	printf("host:       %.1f mS\n",host_ms);
+}
+
+/** \brief print the usage */
+static void usage(void){
+	fprintf(stderr,"usage: wol_replay [-r rate] [-m main_us] [-o dir] [-s scale] [-t] [-n] <trace>\n"
+		"       wol_replay -c <csv>\n"
+		"  -r  replay rate, 2 = twice as fast as recorded (1)\n"
+		"  -m  main loop time per LATCH byte in uS (%.0f)\n"
+		"  -o  directory of the PPM frames (.)\n"
+		"  -s  PPM pixels per LED (1)\n"
+		"  -t  PPM of the tile as mounted, orientation applied\n"
+		"  -n  no PPM frames\n"
+		"  -c  convert a logic analyzer CSV (time,LATCH,SCK,MOSI) into a trace\n",REPLAY_MAIN_US);
+	exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv){
+	const char *capture = NULL;
+	FILE *file;
+	clock_t start;
+	int i;
+	for(i=1;i<argc && argv[i][0] == '-';i++){
+		if(!strcmp(argv[i],"-n")){
+			replay_render = 0;
+			continue;
+		}
+		if(!strcmp(argv[i],"-t")){
+			replay_mounted = 1;
+			continue;
+		}
+		if(i+1 >= argc){
+			usage();
+		}
+		if(!strcmp(argv[i],"-r")){
+			replay_rate = atof(argv[++i]);
+		} else if(!strcmp(argv[i],"-m")){
+			replay_main_us = atof(argv[++i]);
+		} else if(!strcmp(argv[i],"-o")){
+			replay_dir = argv[++i];
+		} else if(!strcmp(argv[i],"-s")){
+			replay_scale = atoi(argv[++i]);
+		} else if(!strcmp(argv[i],"-c")){
+			capture = argv[++i];
+		} else {
+			usage();
+		}
+	}
+	if(capture){
+		file = fopen(capture,"r");
+		if(!file){
+			perror(capture);
+			return EXIT_FAILURE;
+		}
+		convert_capture(file);
+		fclose(file);
+		return EXIT_SUCCESS;
+	}
+	if(i+1 != argc || replay_rate <= 0 || replay_main_us < 0 || replay_scale < 1){
+		usage();
+	}
+	file = fopen(argv[i],"r");
+	if(!file){
+		perror(argv[i]);
+		return EXIT_FAILURE;
+	}
+	start = clock();
+	init_tile();
+	replay_trace(file);
+	fclose(file);
+	print_report((clock()-start)*1000.0/CLOCKS_PER_SEC);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,11 @@
+/**
+ * \brief 	Host replay - no busy waits, the replay counts its own time
+ * \file	util/delay.h
+ */
+
+#ifndef REPLAY_UTIL_DELAY_H_
+#define REPLAY_UTIL_DELAY_H_
+#define _delay_us(us) do{}while(0)
+#define _delay_ms(ms) do{}while(0)
+
+#endif /* REPLAY_UTIL_DELAY_H_ */